@@ -0,0 +1,44 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Samples indices in constant time according to a fixed set of weights, using Vose's alias method.
+ * Building the table takes linear time; every sample then costs one random index and one random float.
+ *
+ * @note Sampling draws from the provided FRandomStream only, so a given seed always produces the same sequence of indices.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Math/RandomStream.h"
+
+class ARPG_API FAliasTable
+{
+public:
+	/** Creates an empty table. */
+	FAliasTable() = default;
+
+	/**
+	 * Creates a table sampling index i with probability Weights[i] / (sum of Weights).
+	 * Negative weights are treated as zero; if every weight is zero, indices are sampled uniformly.
+	 */
+	explicit FAliasTable(TConstArrayView<float> Weights);
+
+	/**
+	 * Returns a random index drawn from the table's distribution.
+	 *
+	 * @warning An assertion is triggered if the table is empty.
+	 */
+	int32 Sample(const FRandomStream& RandomStream) const;
+
+	/** Returns the number of indices in the table. */
+	int32 Num() const;
+
+	/** Returns the number of bytes allocated by the table. */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	TArray<float> m_Probabilities; // Probability of keeping the index drawn, rather than taking its alias
+
+	TArray<int32> m_Aliases;       // Index returned when the drawn index is not kept
+};
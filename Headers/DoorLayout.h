@@ -0,0 +1,135 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Describes which segments of a room's four walls hold doors, using one bitmask per wall.
+ * Bit i of a wall's mask is set when the segment at index i of that wall holds a door.
+ *
+ * Layouts allow door sets to be validated, compared and applied as a whole rather than one door at a time.
+ *
+ * @note A wall can have at most MaxSegmentsPerWall segments tracked by a layout.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/Enums/Direction.h"
+
+struct FDoorLayout
+{
+	using FWallMask = uint64;
+
+	static constexpr int32 NumWalls{ 4 };
+
+	static constexpr int32 MaxSegmentsPerWall{ 64 };
+
+	/** Every wall direction, ordered by wall index. */
+	static constexpr EDirection WallDirections[NumWalls]{ EDirection::North, EDirection::South, EDirection::East, EDirection::West };
+
+	/** Returns the position of the given wall within WallDirections. */
+	static int32 GetWallIndex(const EDirection Direction)
+	{
+		switch (Direction)
+		{
+			case EDirection::North: return 0;
+			case EDirection::South: return 1;
+			case EDirection::East:	return 2;
+			case EDirection::West:  return 3;
+
+			default:
+				checkf(false, TEXT("Error: Invalid argument given to GetWallIndex()"));
+				return 0;
+		}
+	}
+
+	/** Returns a mask with a bit set for every segment of a wall with the given number of segments. */
+	static FWallMask GetSegmentsMask(const int32 NumSegments)
+	{
+		checkf(NumSegments >= 0 && NumSegments <= MaxSegmentsPerWall, TEXT("Error: A wall has more segments than a door layout supports"));
+
+		return NumSegments == MaxSegmentsPerWall ? ~FWallMask{ 0 } : (FWallMask{ 1 } << NumSegments) - 1;
+	}
+
+	/** Returns true if there is a door at the given segment of the given wall. */
+	bool HasDoor(const EDirection Wall, const int32 SegmentIndex) const
+	{
+		return (GetWallMask(Wall) & GetSegmentBit(SegmentIndex)) != 0;
+	}
+
+	/** Marks the given segment of the given wall as holding a door. */
+	void AddDoor(const EDirection Wall, const int32 SegmentIndex)
+	{
+		m_WallMasks[GetWallIndex(Wall)] |= GetSegmentBit(SegmentIndex);
+	}
+
+	/** Marks the given segment of the given wall as not holding a door. */
+	void RemoveDoor(const EDirection Wall, const int32 SegmentIndex)
+	{
+		m_WallMasks[GetWallIndex(Wall)] &= ~GetSegmentBit(SegmentIndex);
+	}
+
+	/** Returns the mask of the given wall. */
+	FWallMask GetWallMask(const EDirection Wall) const
+	{
+		return m_WallMasks[GetWallIndex(Wall)];
+	}
+
+	/** Replaces the mask of the given wall. */
+	void SetWallMask(const EDirection Wall, const FWallMask Mask)
+	{
+		m_WallMasks[GetWallIndex(Wall)] = Mask;
+	}
+
+	/** Returns the number of doors on the given wall. */
+	int32 GetNumDoors(const EDirection Wall) const
+	{
+		return static_cast<int32>(FMath::CountBits(GetWallMask(Wall)));
+	}
+
+	/** Returns the number of doors across every wall. */
+	int32 GetNumDoors() const
+	{
+		int32 NumDoors{ 0 };
+		for (const FWallMask Mask : m_WallMasks)
+		{
+			NumDoors += static_cast<int32>(FMath::CountBits(Mask));
+		}
+		return NumDoors;
+	}
+
+	/**
+	 * Returns true if every door of the other layout is also in this layout.
+	 * Used with a room's door slots to check, in a handful of bitwise operations, that the room can hold a set of doors.
+	 */
+	bool Contains(const FDoorLayout& Other) const
+	{
+		for (int32 WallIndex{ 0 }; WallIndex < NumWalls; ++WallIndex)
+		{
+			if ((Other.m_WallMasks[WallIndex] & ~m_WallMasks[WallIndex]) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool operator==(const FDoorLayout& Other) const
+	{
+		return FMemory::Memcmp(m_WallMasks, Other.m_WallMasks, sizeof(m_WallMasks)) == 0;
+	}
+
+	bool operator!=(const FDoorLayout& Other) const
+	{
+		return !(*this == Other);
+	}
+
+private:
+	FWallMask m_WallMasks[NumWalls]{ };	// One mask per wall, ordered by wall index
+
+	/** Returns the bit representing the given segment within a wall mask. */
+	static FWallMask GetSegmentBit(const int32 SegmentIndex)
+	{
+		checkf(SegmentIndex >= 0 && SegmentIndex < MaxSegmentsPerWall, TEXT("Error: Segment index is out of the range supported by a door layout"));
+
+		return FWallMask{ 1 } << SegmentIndex;
+	}
+};
@@ -8,6 +8,15 @@
 
 #pragma once
 #include "Dungeon/Rooms/DungeonRoom.h"
+#include "Dungeon/InstancedSegmentRenderer.h"
+#include "Dungeon/DungeonTileGrid.h"
+#include "Dungeon/DungeonRoomGraph.h"
+#include "Dungeon/DungeonRoomTable.h"
+#include "Dungeon/DungeonLayout.h"
+#include "Dungeon/Rooms/DungeonRoomDatabase.h"
+#include "Dungeon/ReplicatedDungeonRooms.h"
+#include "Dungeon/Rooms/DungeonRoomAsyncSpawner.h"
+#include "Dungeon/Rooms/DungeonRoomPrefetcher.h"
 
 
 #include "CoreMinimal.h"
@@ -23,17 +32,349 @@ private:
 	UPROPERTY(VisibleAnywhere)
 	USceneComponent* m_RootComponent;      // Top level component used for scene organization; All rooms are children of the root
 
-	TArray<ADungeonRoom*> m_RoomsArray{ }; // Contains every room in the dungeon
+	TArray<ADungeonRoom*> m_RoomsArray{ }; // Contains every room in the dungeon; null while a room is streamed out
+
+	TMap<const ADungeonRoom*, int32> m_RoomIndices{ }; // Maps every streamed in room to its index in m_RoomsArray
+
+	/** The state kept for every room, whether or not its actor is streamed in. */
+	struct FRoomRecord
+	{
+		FSoftObjectPath ClassPath;		// the class the room is spawned from when it is streamed back in
+
+		FSoftObjectPath AssetPath;		// the room's path in the room database, if it was spawned from a layout or a snapshot
+
+		FRandomStream   RandomStream;		// the stream the room was spawned with
+
+		bool 		bIsStreamingIn{ false };// true while the room's asset is loading
+	};
+
+	TArray<FRoomRecord> m_RoomRecords{ };	       // The record of every room, ordered like m_RoomsArray
+
+	FDungeonRoomTable m_RoomTable{ };      // The footprint and doors of every room, whether or not it is streamed in; ordered like m_RoomsArray
+
+	FDungeonTileGrid m_RoomGrid{ };	       // Records which room occupies each tile; rooms are identified by their index in m_RoomsArray
+
+	FDungeonRoomGraph m_RoomGraph{ };      // Records which rooms are connected by facing doors; kept up to date as doors change
+
+	/**
+	 * The size of a single tile in world units.
+	 * Rooms are placed on a grid of this size, relative to the dungeon's location, with their actor location at their south-west corner.
+	 */
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "1.0"))
+	float m_TileSize{ 400.0f };
+
+	/**
+	 * When enabled, the wall and door segments of every room added to the dungeon are rendered through
+	 * shared instanced components (one per mesh) rather than one component per segment.
+	 * Intended for large floors where render-thread cost and component registration dominate.
+	 */
+	UPROPERTY(EditAnywhere)
+	bool m_bUseInstancedSegments{ false };
+
+	/**
+	 * When enabled, every room added to the dungeon has its segments merged by ADungeonRoom::FinalizeSegments.
+	 * Ignored when m_bUseInstancedSegments is enabled, which already batches the segments of every room.
+	 */
+	UPROPERTY(EditAnywhere)
+	bool m_bFinalizeRooms{ false };
+
+	UPROPERTY(VisibleAnywhere)
+	UInstancedSegmentRenderer* m_SegmentRenderer;  // Renders the segments of every room when m_bUseInstancedSegments is enabled
+
+	/** The seed the current layout was spawned with; replicated so clients pick the same meshes as the server. */
+	UPROPERTY(Replicated)
+	int32 m_Seed{ 0 };
+
+	/** Describes every room spawned from a layout; replicated so clients spawn the rooms locally rather than replicating each actor. */
+	UPROPERTY(Replicated)
+	FReplicatedDungeonRoomArray m_ReplicatedRooms;
+
+	TSharedPtr<const FDungeonRoomDatabase> m_RoomDatabase;  // Translates between asset paths and the asset indices used by m_ReplicatedRooms
+
+	TMap<int32, int32> m_ReplicationIDsByRoomIndex{ };    // Maps the index of every room described by m_ReplicatedRooms to the replication ID of its item
+
+	TMap<int32, int32> m_RoomIndicesByReplicationID{ };    // Maps the replication ID of every item of m_ReplicatedRooms to the index of its room
+
+	TMap<int32, int32> m_ItemIndicesByReplicationID{ };    // Server only; maps the replication ID of every item to its position in m_ReplicatedRooms.Rooms
+
+	TSet<int32> m_PendingReplicationIDs{ };		       // Clients only; the items that were added or changed since they were last applied
+
+	bool m_bHasRemovedReplicatedRooms{ false };	       // Clients only; true if items were removed since they were last applied
+
+	/**
+	 * When enabled, rooms far from every player are destroyed and spawned again once a player comes near, keeping their doors.
+	 * Bounds memory and render cost by the neighborhood of the players rather than the size of the dungeon.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Streaming")
+	bool m_bStreamRooms{ false };
+
+	/** Rooms at most this many doors away from a room containing a player stay streamed in. */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "0", EditCondition = "m_bStreamRooms"))
+	int32 m_StreamingHops{ 2 };
+
+	/** Rooms within this distance of a player stay streamed in, regardless of doors. Disabled when 0. */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "0.0", EditCondition = "m_bStreamRooms"))
+	float m_StreamingDistance{ 0.0f };
+
+	/** The number of seconds between streaming updates. */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "0.0", EditCondition = "m_bStreamRooms"))
+	float m_StreamingInterval{ 0.25f };
+
+	TUniquePtr<FDungeonRoomAsyncSpawner> m_StreamingSpawner;  // Spawns streamed in rooms across frames once their assets have loaded
+
+	/** The estimated size of the next floor's room assets kept loaded by PrefetchNextFloor, in megabytes. */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "0"))
+	int32 m_PrefetchBudgetMegabytes{ 256 };
+
+	TUniquePtr<FDungeonRoomPrefetcher> m_Prefetcher;	  // Streams in the next floor's room assets; created by the first call to PrefetchNextFloor
+
+	FStreamableManager m_SnapshotStreamer;			  // Streams in the room assets of a snapshot being restored
+
+	TSharedPtr<FStreamableHandle> m_SnapshotLoadHandle;	  // Keeps the assets of the snapshot being restored loaded until its rooms are spawned
 
 public:	
 	ADungeon();
 	/**
-    	 * Attaches the provided room to the dungeon.
+    	 * Attaches the provided room to the dungeon and records its footprint in the dungeon's tile grid.
+	 * If instanced segments are enabled, the room's segments are handed over to the dungeon's segment renderer.
+	 *
+	 * @warning An assertion is triggered if the room overlaps a room already in the dungeon.
      	 */
 	void AddRoom(ADungeonRoom* Room);
 
+	/**
+	 * Spawns and adds a room for every room of the layout, with the layout's doors.
+	 * Tile (0, 0) of the layout is placed at the dungeon's location. Room assets that are not loaded yet are loaded synchronously.
+	 * The rooms are spawned as a single batch; see ADungeonRoom::SpawnBatch. A snapshot still being restored is cancelled.
+	 *
+	 * @param Seed - Determines the door and wall meshes of every room; see GetRoomRandomStream.
+	 * @return The spawned rooms, in the layout's order; null for rooms whose asset failed to load.
+	 */
+	TArray<ADungeonRoom*> SpawnLayout(const FDungeonLayout& Layout, int32 Seed);
+
+	/**
+	 * Returns the stream driving the mesh choices of the room at the given index of a layout spawned with the given seed.
+	 * Each room's stream depends only on the seed and the room's index, so a server and its clients that share the seed
+	 * build identical rooms without replicating mesh choices, regardless of the order the rooms are spawned in.
+	 */
+	static FRandomStream GetRoomRandomStream(int32 Seed, int32 RoomIndex);
+
+	/**
+	 * Removes every room from the dungeon, such as when moving to the next floor.
+	 * Rooms are released to the world's UDungeonRoomPool so the next floor can reuse them; they are destroyed if there is no pool.
+	 */
+	void ReleaseRooms();
+
+	/**
+	 * Sets the database used to replicate rooms by asset index rather than by path.
+	 * Must be set on the server before spawning a layout, and on clients for them to spawn the replicated rooms.
+	 */
+	void SetRoomDatabase(TSharedPtr<const FDungeonRoomDatabase> RoomDatabase);
+
+	/**
+	 * Starts streaming in the room assets of the next floor at a low priority, so that spawning it does not wait on loads.
+	 * Pass the next floor's layout when it is generated ahead of time; its assets are requested before the rest of the theme.
+	 *
+	 * @warning An assertion is triggered if the room database has not been set; see SetRoomDatabase.
+	 */
+	void PrefetchNextFloor(EDungeonTheme Theme, const FDungeonLayout* NextLayout = nullptr);
+
+	/** Called once the rooms of a restored snapshot have been spawned; receives them in the snapshot's order, null for rooms that failed to load. */
+	using FOnSnapshotRestored = TFunction<void(const TArray<ADungeonRoom*>&)>;
+
+	/**
+	 * Writes every room of the dungeon, whether or not it is streamed in, to a compact binary snapshot.
+	 * Rooms are stored by tile, door masks, the seed they were spawned with and an index into a table of the paths of their assets, along with the dungeon's seed.
+	 * Only the paths of the assets the rooms use are stored, so adding, removing or renaming other room assets keeps the snapshot readable.
+	 *
+	 * @return False, leaving OutBytes empty, if the room database is not set or a room's asset is not in it.
+	 */
+	bool SaveSnapshot(TArray<uint8>& OutBytes) const;
+
+	/** Writes the snapshot given by SaveSnapshot to the file. Returns true if the file was written. */
+	bool SaveSnapshotToFile(const FString& FilePath) const;
+
+	/**
+	 * Replaces the rooms of the dungeon with those of a snapshot given by SaveSnapshot.
+	 * The snapshot is validated up front; the assets of its rooms are then streamed in asynchronously and the rooms spawned as a single batch.
+	 * Every room is spawned with the seed it was originally spawned with, so it picks the meshes it first picked rather than those picked by later door changes.
+	 * A snapshot still loading from an earlier call is cancelled once this one is found valid; OnRestored may itself restore another snapshot.
+	 *
+	 * @return False, leaving the dungeon unchanged, if the snapshot is malformed, from another version, or uses an asset that is not in the room database,
+	 *         or if any of its rooms overlap or lie too far from the dungeon's origin to be replicated.
+	 */
+	bool RestoreSnapshot(TConstArrayView<uint8> Bytes, FOnSnapshotRestored OnRestored = nullptr);
+
+	/** Reads the file in a single read and restores the snapshot it holds; see RestoreSnapshot. */
+	bool RestoreSnapshotFromFile(const FString& FilePath, FOnSnapshotRestored OnRestored = nullptr);
+
+	/** Returns true if a restored snapshot's assets are still loading, so its rooms have not been spawned yet. */
+	bool IsRestoringSnapshot() const;
+
+	/** Returns the number of rooms in the dungeon, including those streamed out. */
+	int32 GetNumRooms() const;
+
+	/** Returns the room with the given index, or null if the room is streamed out. */
+	ADungeonRoom* GetRoom(int32 RoomIndex) const;
+
+	/** Returns the doors of the room with the given index, whether or not it is streamed in. */
+	FDoorLayout GetRoomDoorLayout(int32 RoomIndex) const;
+
+	/** Returns the footprint and doors of every room, for passes over the whole dungeon such as counting doors or drawing a minimap. */
+	const FDungeonRoomTable& GetRoomTable() const;
+
+	/**
+	 * Streams rooms in or out based on the given viewer locations; called automatically every streaming interval when streaming is enabled.
+	 * A room stays streamed in if it is within m_StreamingHops doors of a room containing a viewer, or within m_StreamingDistance of a viewer.
+	 * Streamed in rooms are loaded and spawned asynchronously.
+	 *
+	 * @note Nothing is streamed out while there are no viewers in the dungeon, such as while players respawn.
+	 */
+	void UpdateStreaming(TConstArrayView<FVector> ViewerLocations);
+
+	/** Returns the world location of the south-west corner of the given tile. */
+	FVector TileToWorld(const FIntPoint& Tile) const;
+
+	/** Returns the tile containing the given world location. */
+	FIntPoint WorldToTile(const FVector& WorldLocation) const;
+
+	/** Returns the tiles occupied by the given room, based on its location and dimensions. */
+	FTileFootprint GetFootprint(const ADungeonRoom* Room) const;
+
+	/** Returns true if a room with the given footprint can be added without overlapping an existing room. */
+	bool CanPlaceRoom(const FTileFootprint& Footprint) const;
+
+	/** Returns the room containing the given world location, or null if there is none or it is streamed out. */
+	ADungeonRoom* FindRoomAtLocation(const FVector& WorldLocation) const;
+
+	/** Adds every streamed in room overlapping the given world-space box to OutRooms. */
+	void FindRoomsInBox(const FBox& WorldBox, TArray<ADungeonRoom*>& OutRooms) const;
+
+	/** Returns the room on the other side of the given wall segment of a room, or null if there is none or it is streamed out. */
+	ADungeonRoom* FindNeighbor(const ADungeonRoom* Room, const ADungeonRoom::FWallLocation& Location) const;
+
+	/** Adds every streamed in room sharing a wall with the given room to OutNeighbors. */
+	void FindNeighbors(const ADungeonRoom* Room, TArray<ADungeonRoom*>& OutNeighbors) const;
+
+	/**
+	 * Returns the graph of rooms connected by doors. Rooms are identified by the order they were added to the dungeon.
+	 * Two rooms are connected when each has a door on the segment facing the other's door.
+	 */
+	const FDungeonRoomGraph& GetRoomGraph() const;
+
+	/** Returns true if the player can walk from one room to the other through doors. */
+	bool AreRoomsConnected(const ADungeonRoom* RoomA, const ADungeonRoom* RoomB) const;
+
+	/** Returns true if every room can be reached from every other room through doors. */
+	bool IsFullyConnected() const;
+
+	/** Returns the number of doors that must be passed through to walk from one room to the other, or INDEX_NONE if they are not connected. */
+	int32 GetRoomDistance(const ADungeonRoom* RoomA, const ADungeonRoom* RoomB) const;
+
+	/** Structure describing the memory attributed to a dungeon; see GetMemoryReport */
+	struct FMemoryReport
+	{
+		TArray<TPair<const ADungeonRoom*, ADungeonRoom::FMemoryReport>> Rooms;	// the report of every streamed in room
+
+		int32 NumStreamedOutRooms{ 0 };		// the rooms kept only as records; they hold no components
+
+		int64 ComponentBytes{ 0 };		// the components of every room and of the dungeon itself, such as its instanced segments
+
+		int64 RenderProxyBytes{ 0 };		// the render proxies of those components
+
+		int64 AssetBytes{ 0 };			// the meshes referenced by any room, each counted once however many rooms share it
+
+		int64 PrefetchedBytes{ 0 };		// the assets of the next floor held by the prefetcher
+
+		int64 DatabaseBytes{ 0 };		// the maps and indices of the room database
+
+		int64 BookkeepingBytes{ 0 };		// the dungeon's own room records, grid, graph, table and replication maps
+
+		/** Returns the sum of every category; meshes shared with the prefetched assets are counted twice. */
+		int64 GetTotalBytes() const;
+	};
+
+	/**
+	 * Measures the memory held by the dungeon and its rooms: components, render proxies, referenced meshes, the room database and the dungeon's own bookkeeping.
+	 * Also available through the Dungeon.MemoryReport console command.
+	 *
+	 * @note Proxies are owned by the render thread; flush rendering commands first for their sizes to be current.
+	 */
+	FMemoryReport GetMemoryReport() const;
+
+	/** Logs GetMemoryReport, including a line for every streamed in room if bIncludeRooms is true. */
+	void LogMemoryReport(bool bIncludeRooms) const;
+
+	//~ Begin AActor Interface
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostRepNotifies() override;
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End AActor Interface
+
 protected:
+	/** Connects or disconnects the rooms on either side of a door when the door changes. */
+	void HandleDoorChanged(ADungeonRoom* Room, const ADungeonRoom::FWallLocation& Location, bool bHasDoor);
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+private:
+	/** Attaches the room to the slot of the given index and starts listening to its doors. */
+	void InstallRoom(ADungeonRoom* Room, int32 RoomIndex);
+
+	/** Connects or disconnects the door of the given room in the room graph. */
+	void UpdateDoorConnection(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex, bool bHasDoor);
+
+	/** Updates the doors of the given room, whether or not it is streamed in. */
+	void SetRoomDoorLayout(int32 RoomIndex, const FDoorLayout& Layout);
+
+	/** Destroys the actor of the given room, keeping its doors in its record. */
+	void StreamOutRoom(int32 RoomIndex);
+
+	/** Starts loading and spawning the actors of the given rooms. */
+	void StreamInRooms(TConstArrayView<int32> RoomIndices);
+
+	/** Returns true if the room is within m_StreamingDistance of any of the viewers. */
+	bool IsRoomNearViewer(int32 RoomIndex, TConstArrayView<FVector> ViewerLocations) const;
+
+	/** A room read from a snapshot. */
+	struct FSnapshotRoom
+	{
+		FSoftObjectPath AssetPath;	// the asset to spawn
+
+		FIntPoint 	Origin;		// the room's south-west tile
+
+		int32 		RandomSeed{ 0 };	// the seed of the stream the room was originally spawned with
+
+		FDoorLayout 	Doors;		// every door of the room, including the blueprint's own
+	};
+
+	/** Cancels the restore whose assets are still loading, if any, so that its rooms are never spawned. */
+	void CancelSnapshotRestore();
+
+	/** Spawns and adds the rooms of a restored snapshot once their assets have loaded. */
+	void SpawnSnapshotRooms(TConstArrayView<FSnapshotRoom> SnapshotRooms, const FOnSnapshotRestored& OnRestored);
+
+	/** Adds an item describing the room to m_ReplicatedRooms. Does nothing if the room's asset is not in the database. */
+	void AddReplicatedRoom(int32 RoomIndex, const FSoftObjectPath& AssetPath, const FIntPoint& Origin, int32 LayoutIndex);
+
+	/** Copies the room's doors to its item in m_ReplicatedRooms, if it has one. */
+	void UpdateReplicatedDoors(int32 RoomIndex);
+
+	/** Clients only; queues the item to be applied once every replicated property has been received. */
+	void OnReplicatedRoomChanged(int32 ReplicationID);
+
+	/** Clients only; queues the removal of every room, to be followed by spawning the remaining items again. */
+	void OnReplicatedRoomRemoved(int32 ReplicationID);
+
+	/** Clients only; spawns the rooms of new items and updates the doors of changed ones. Waits until the database is set. */
+	void ApplyReplicatedRooms();
+
+	/** Spawns and adds the room described by the item. */
+	ADungeonRoom* SpawnReplicatedRoom(const FReplicatedDungeonRoom& Item);
+
+	/* Notifies the dungeon of replicated changes */
+	friend struct FReplicatedDungeonRoom;
+
 };
@@ -0,0 +1,85 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: A plain-data description of a dungeon: which room assets it contains, where each sits on the tile grid,
+ * and which wall segments hold doors. Layouts can be built, validated and discarded without spawning any actors,
+ * and are turned into a dungeon with ADungeon::SpawnLayout.
+ *
+ * Bounds and door rules mirror those of ADungeonRoom: a North or South wall has one segment per tile of width,
+ * and an East or West wall has one segment per tile of length. See FDungeonTileGrid for the grid conventions.
+ * Wall and door slot checks go through VisitRoomLayout, so the common footprints check against compile-time segment counts.
+ *
+ * @note Layouts do not reference any UObject, so they can be built on any thread.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/Structs/DungeonRoomSpecs.h"
+#include "Dungeon/Rooms/DoorLayout.h"
+#include "Dungeon/DungeonTileGrid.h"
+
+/** A single room within a layout. */
+struct FDungeonLayoutRoom
+{
+	FSoftObjectPath AssetPath;	// the asset to spawn
+
+	FDungeonRoomSpecs Specs;	// the specs of the asset
+
+	FTileFootprint  Footprint;	// the tiles occupied by the room
+
+	FDoorLayout 	Doors;		// the doors added to the room when it is spawned
+
+	FDoorLayout 	DoorSlots;	// the segments of the asset that can hold a door
+};
+
+class ARPG_API FDungeonLayout
+{
+public:
+	/** Returns true if a room with the given footprint can be added without overlapping a room already in the layout. */
+	bool CanPlaceRoom(const FTileFootprint& Footprint) const;
+
+	/**
+	 * Adds a room without any doors.
+	 *
+	 * @param DoorSlots - The segments of the asset that can hold a door, such as given by FDungeonRoomDatabase::FindDoorSlots.
+	 * @return The index of the room within the layout.
+	 * @warning An assertion is triggered if the room overlaps a room already in the layout, if its footprint does not match its specs,
+	 *          or if a door slot lies outside of its walls.
+	 */
+	int32 AddRoom(const FSoftObjectPath& AssetPath, const FDungeonRoomSpecs& Specs, const FTileFootprint& Footprint, const FDoorLayout& DoorSlots);
+
+	/** Returns true if the segment exists on the given wall of the room; the layout counterpart of ADungeonRoom::IsValidWallLocation. */
+	bool IsValidWallLocation(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex) const;
+
+	/** Returns true if the segment exists on the given wall of the room, is one of the room's door slots, and has no door yet. */
+	bool IsFreeDoorSlot(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex) const;
+
+	/**
+	 * Adds a door at the given segment of the room, along with a door on the facing segment of the room across it.
+	 *
+	 * @return False, leaving the layout unchanged, if either segment already holds a door or is not a door slot, or if there is no room across the segment.
+	 * @warning An assertion is triggered if the location is not valid.
+	 */
+	bool ConnectRooms(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex);
+
+	/** Returns the rooms of the layout, in the order they were added. */
+	const TArray<FDungeonLayoutRoom>& GetRooms() const;
+
+	/** Returns the tile grid of the layout; rooms are identified by their index within GetRooms(). */
+	const FDungeonTileGrid& GetGrid() const;
+
+	/** Returns the number of rooms in the layout. */
+	int32 Num() const;
+
+	/** Preallocates room for the given number of rooms covering the given number of tiles in total. */
+	void Reserve(int32 NumRooms, int32 NumTiles);
+
+	/** Removes every room, keeping the allocations so that the layout can be rebuilt without touching the heap. */
+	void Reset();
+
+private:
+	TArray<FDungeonLayoutRoom> m_Rooms;	// Every room of the layout, in the order they were added
+
+	FDungeonTileGrid 	   m_Grid;	// Records which room occupies each tile
+};
@@ -0,0 +1,107 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Generates dungeon layouts entirely from the data held by an FDungeonRoomDatabase, without spawning any actors.
+ *
+ * A layout is grown from a single starting room: each step picks a random free wall segment of a room already placed,
+ * picks a room asset of the requested theme that can hold a door there, and places it so that one of its segments faces the chosen one.
+ * The two facing segments receive doors, so every layout produced is fully connected.
+ *
+ * Generation is deterministic for a given database and seed.
+ *
+ * An optional asset memory budget bounds the estimated size of the distinct assets a layout references, such as on low-memory platforms.
+ * Once a new asset would exceed it, rooms reuse assets of the same specs already in the layout, and placements with no such asset are rejected.
+ * Sizes come from FDungeonRoomDatabase::GetEstimatedAssetSize, so the budget only binds databases whose sizes were measured, such as snapshots built at cook time.
+ *
+ * Generate() only reads from the generator and its database, so any number of threads may generate layouts with one generator at once.
+ *
+ * @note The database must not be modified while layouts are being generated on other threads; see FDungeonRoomDatabase.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/DungeonLayout.h"
+#include "Dungeon/Rooms/DungeonRoomDatabase.h"
+
+class ARPG_API FDungeonLayoutGenerator
+{
+public:
+	/** Structure defining the layout to generate */
+	struct FSettings
+	{
+		EDungeonTheme Theme;			// the theme of every room in the layout
+
+		int32 	      NumRooms{ 8 };		// the number of rooms the layout must contain
+
+		int32 	      MaxAttemptsPerRoom{ 32 };	// the number of placements tried for each room before generation fails
+
+		int64 	      AssetMemoryBudgetBytes{ 0 };// the estimated size of the distinct assets a layout may reference; 0 for no budget
+	};
+
+	/**
+	 * Creates a generator drawing rooms from the given database.
+	 *
+	 * @note The database must outlive the generator.
+	 */
+	FDungeonLayoutGenerator(const FDungeonRoomDatabase& Database, const FSettings& Settings);
+
+	/**
+	 * Generates a layout using the given seed.
+	 * OutLayout is reset and reserved for the largest layout the settings can produce, so reusing one layout across calls,
+	 * such as one per floor or per worker thread, generates without allocating once it has grown.
+	 *
+	 * @return True if a layout with the requested number of rooms was generated; OutLayout holds the partial layout otherwise.
+	 */
+	bool Generate(int32 Seed, FDungeonLayout& OutLayout) const;
+
+	/** Returns the estimated size of the distinct assets the layout references; the quantity bounded by AssetMemoryBudgetBytes. */
+	int64 GetEstimatedAssetSize(const FDungeonLayout& Layout) const;
+
+private:
+	/** The distinct assets of the layout being generated, tracked against the asset memory budget. */
+	struct FAssetBudget
+	{
+		TArray<FSoftObjectPath, TInlineAllocator<16>>	UsedAssets;	// every distinct asset placed so far
+
+		TArray<FDungeonRoomSpecs, TInlineAllocator<16>> UsedSpecs;	// the specs of each entry of UsedAssets
+
+		int64 						UsedBytes{ 0 };	// the estimated size of every entry of UsedAssets
+
+		/** Records that a room of the asset was placed. */
+		void Add(const FSoftObjectPath& AssetPath, const FDungeonRoomSpecs& Specs, int64 EstimatedSize);
+	};
+
+	const FDungeonRoomDatabase& m_Database;		// Provides the rooms placed in the layout
+
+	FSettings 		    m_Settings;		// Describes the layout to generate
+
+	TArray<FDungeonRoomSpecs>   m_CandidateSpecs;	// The specs of every room of the requested theme, in a stable order
+
+	int32 			    m_MaxRoomArea{ 0 };	// The number of tiles covered by the largest candidate room
+
+	/**
+	 * Adds a randomly chosen room at the origin of the layout.
+	 *
+	 * @return False if the chosen room alone exceeds the asset memory budget.
+	 */
+	bool PlaceFirstRoom(FRandomStream& RandomStream, FDungeonLayout& Layout, FAssetBudget& Budget) const;
+
+	/**
+	 * Tries to attach a randomly chosen room to a random free segment of a room already in the layout.
+	 *
+	 * @return True if the room was placed and connected.
+	 */
+	bool TryPlaceRoom(FRandomStream& RandomStream, FDungeonLayout& Layout, FAssetBudget& Budget) const;
+
+	/**
+	 * Randomly selects an asset with the given specs that can hold every required door and fits within the asset memory budget.
+	 * Samples as the database does; if the sampled asset is new to the layout and does not fit, a suitable asset already in the layout is reused instead.
+	 *
+	 * @return Null if no asset with the given specs can hold the doors within the budget.
+	 */
+	const FSoftObjectPath* SampleAssetWithinBudget(const FDungeonRoomSpecs& Specs, const FDoorLayout& RequiredDoors, FRandomStream& RandomStream, const FAssetBudget& Budget) const;
+
+	/** Returns the footprint of a room with the given specs placed so that its segment on the given wall lies on the given tile. */
+	static FTileFootprint GetFootprintFacingTile(const FDungeonRoomSpecs& Specs, const EDirection Wall, const int32 SegmentIndex, const FIntPoint& Tile);
+};
@@ -0,0 +1,84 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Generates many candidate layouts in parallel, each from its own seed, and keeps the one with the best score.
+ * Candidates are spread across the task graph's worker threads with ParallelFor.
+ *
+ * The best candidate is the one with the highest score, with ties going to the lowest seed. The result therefore does not
+ * depend on how candidates were scheduled, unless the search is cancelled or stopped at a target score.
+ *
+ * @note The score function is called from worker threads, so it must be thread-safe.
+ * @note A search reuses its workers' layouts across runs, so a single search must not run more than once at a time.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/DungeonLayoutGenerator.h"
+
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+class ARPG_API FDungeonLayoutSearch
+{
+public:
+	/** Returns how desirable a layout is; higher is better. Called concurrently from worker threads. */
+	using FScoreFunction = TFunction<float(const FDungeonLayout&)>;
+
+	/** A generated layout along with the seed it was generated from and its score. */
+	struct FCandidate
+	{
+		FDungeonLayout Layout;
+
+		int32 	       Seed{ 0 };
+
+		float 	       Score{ 0.0f };
+	};
+
+	/**
+	 * Creates a search generating layouts with the given generator.
+	 *
+	 * @param TargetScore - The remaining candidates are skipped once a candidate reaches this score.
+	 * @note The generator must outlive the search.
+	 */
+	FDungeonLayoutSearch(const FDungeonLayoutGenerator& Generator, FScoreFunction ScoreFunction, float TargetScore = MAX_flt);
+
+	/**
+	 * Generates NumCandidates layouts from the seeds FirstSeed to FirstSeed + NumCandidates - 1, blocking until every candidate is done.
+	 *
+	 * @return The best candidate, or an empty optional if no candidate could be generated.
+	 */
+	TOptional<FCandidate> Run(int32 FirstSeed, int32 NumCandidates);
+
+	/**
+	 * Runs the search on the task graph without blocking the caller.
+	 *
+	 * @note The search must outlive the returned future.
+	 */
+	TFuture<TOptional<FCandidate>> RunAsync(int32 FirstSeed, int32 NumCandidates);
+
+	/** Skips every candidate that has not started yet. Safe to call from any thread. */
+	void Cancel();
+
+	/** Returns true if the current search was cancelled. */
+	bool IsCancelled() const;
+
+private:
+	const FDungeonLayoutGenerator& m_Generator;		// Generates every candidate
+
+	FScoreFunction 		       m_ScoreFunction;		// Scores every generated candidate
+
+	float 			       m_TargetScore;		// The score at which the remaining candidates are skipped
+
+	std::atomic<bool> 	       m_bIsCancelled{ false }; // Set by Cancel() or once a candidate reaches the target score
+
+	TArray<FDungeonLayout> 	       m_WorkerLayouts;		// One scratch layout per worker, kept across searches so candidates are generated without allocating
+
+	/** Generates and scores every candidate, assuming the cancel flag has already been reset. */
+	TOptional<FCandidate> Search(int32 FirstSeed, int32 NumCandidates);
+
+	/** Returns true if the candidate with the given seed and score should replace Best as the best candidate. */
+	static bool IsBetterCandidate(int32 Seed, float Score, const FCandidate& Best);
+};
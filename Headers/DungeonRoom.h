@@ -23,6 +23,8 @@
 #include "Dungeon/Enums/DungeonTheme.h"
 #include "Dungeon/Enums/Direction.h"
 #include "Dungeon/SegmentedWall.h"
+#include "Dungeon/InstancedSegmentRenderer.h"
+#include "Dungeon/Rooms/DoorLayout.h"
 
 #include "GameFramework/Actor.h"
 #include "DungeonRoom.generated.h"
@@ -46,28 +48,66 @@ public:
 	/** Structure defining the information required to spawn a room */
 	struct FSpawnInfo
 	{
-		using FDoorLocations = TArray<ADungeonRoom::FWallLocation>;
+		/** Sized for the doors of a typical room, so that building spawn infos does not touch the heap. */
+		using FDoorLocations = TArray<ADungeonRoom::FWallLocation, TInlineAllocator<8>>;
 
 		UObject* 	LoadedAsset;		// the asset to spawn		
 		
 		FVector 	RoomLocation;		// defines where to spawn the room
 		
 		FDoorLocations  DoorLocations;		// defines the locations of the doors
+
+		FRandomStream 	RandomStream{ FMath::Rand() };	// drives every door and wall mesh choice of the room; the same stream gives the same visuals. Randomly seeded unless set
+
+		TOptional<FDoorLayout> DoorLayout;	// optional; replaces the room's doors as a whole, including the blueprint's, instead of adding DoorLocations
+	};
+
+	/** Structure describing the memory attributed to a single room; see GetMemoryReport */
+	struct FMemoryReport
+	{
+		int32 NumComponents{ 0 };		// the static mesh components of the room, including hidden companion segments
+
+		int64 ComponentBytes{ 0 };		// the size of those components
+
+		int32 NumRenderProxies{ 0 };		// the components with a render proxy; collapsed or hidden segments have none
+
+		int64 RenderProxyBytes{ 0 };		// the size of those proxies
+
+		int64 ReferencedAssetBytes{ 0 };	// the size of the door and wall meshes the room can pick from, each counted once
 	};
 
-	/** Spawns a room according to the provided spawn info  */
+	/** Event broadcast whenever a door is added to or removed from the room; receives the room, the location, and true if a door was added. */
+	using FOnDoorChanged = TMulticastDelegate<void(ADungeonRoom*, const FWallLocation&, bool)>;
+
+	/** 
+	 * Spawns a room according to the provided spawn info.
+	 * A room of the asset's class is taken from the world's UDungeonRoomPool if one is available; a new actor is spawned otherwise.
+	 */
 	static ADungeonRoom* Spawn(const FSpawnInfo& SpawnInfo, UWorld* World);
 
+	/**
+	 * Spawns a room for every spawn info, appending them to OutRooms in order; intended for spawning a whole floor at once.
+	 * The actors are created on the game thread, then every room is planned on worker threads: the mesh, component and slot of each
+	 * segment its doors change are resolved from the spawn infos. Finally the plans are applied on the game thread in a single pass.
+	 * The rooms match those given by Spawn with the same infos.
+	 *
+	 * @note Setting a mesh only marks the segment's render state dirty; the world recreates every dirty render state in one batched
+	 *       end-of-frame update, so each changed segment is recreated once per frame however many rooms the batch holds.
+	 */
+	static void SpawnBatch(TConstArrayView<FSpawnInfo> SpawnInfos, UWorld* World, TArray<ADungeonRoom*>& OutRooms);
+
 public:
 	/**
 	 * Adds a door to the room at the specified location. The door static mesh used is randomly selected
-         * from the set of door meshes defined in the blueprint.
-         */
+	 * from the set of door meshes defined in the blueprint the first time the segment holds a door,
+	 * and reused every time after that, so that toggling a door never changes the room's visuals.
+	 */
 	void AddDoor(const FWallLocation& Location);
 
 	/**
-	 * Removes the door from the room at the specified location. The wall static mesh used to replace
-	 * the door is randomly selected from the set of wall meshes defined in the blueprint.
+	 * Removes the door from the room at the specified location. The wall static mesh used to replace the door is
+	 * randomly selected from the set of wall meshes defined in the blueprint the first time the segment holds a wall,
+	 * and reused every time after that.
 	 */
 	void RemoveDoor(const FWallLocation& Location);
 
@@ -84,10 +124,103 @@ public:
 	/** 
 	 * Returns true if the room has a door at the provided location.
 	 * 
+	 * @note Answered from the room's door layout, without inspecting the segment's mesh.
 	 * @warning An assertion is triggered if the location is not valid.
 	 */
 	bool HasDoorAtLocation(const FWallLocation& Location) const;
 
+	/** Returns the locations of every door in the room. */
+	const FDoorLayout& GetDoorLayout() const;
+
+	/** Returns the number of doors on the given wall. */
+	int32 GetNumDoors(const EDirection Direction) const;
+
+	/** Returns true if the given wall has at least one segment without a door. */
+	bool HasFreeSegment(const EDirection Direction) const;
+
+	/** Returns the lowest index of a segment without a door on the given wall, or INDEX_NONE if every segment has a door. */
+	int32 GetFirstFreeSegment(const EDirection Direction) const;
+
+	/** Returns the mask of the segments of the given wall that the blueprint marks as unable to hold a door. */
+	FDoorLayout::FWallMask GetBlockedSegments(const EDirection Direction) const;
+
+	/** Returns the segments of every wall that can hold a door; the runtime counterpart of FDungeonRoomDatabase::FindDoorSlots. */
+	FDoorLayout GetDoorSlots() const;
+
+	/** Returns the mesh displayed by the given segment. */
+	UStaticMesh* GetSegmentMesh(const FWallLocation& Location) const;
+
+	/** Adds every door and wall mesh the room can pick from to OutMeshes, each once; the meshes kept loaded by the room's class. */
+	void GetSegmentMeshes(TArray<UStaticMesh*>& OutMeshes) const;
+
+	/**
+	 * Measures the memory held by the room's components and render proxies, and by the meshes it references.
+	 *
+	 * @note Proxies are owned by the render thread; flush rendering commands first for their sizes to be current.
+	 */
+	FMemoryReport GetMemoryReport() const;
+
+	/**
+	 * Updates the room so that its doors match the provided layout.
+	 * The layout is validated once, and only the segments that differ from the current layout are changed.
+	 * Added doors and replacement walls use each segment's cached mesh, choosing one at random if it has none, as with AddDoor and RemoveDoor.
+	 *
+	 * @warning An assertion is triggered if the layout contains a door outside of the room's walls or on a blocked segment,
+	 *          or if the blueprint is missing the meshes required by the change.
+	 */
+	void ApplyDoorLayout(const FDoorLayout& Layout);
+
+	/** Returns the event broadcast by AddDoor, RemoveDoor and ApplyDoorLayout for every door that changes. */
+	FOnDoorChanged& OnDoorChanged();
+
+	/**
+	 * Hands the rendering of every wall segment over to the provided renderer.
+	 * Once enabled, AddDoor and RemoveDoor move a segment's instance between the renderer's batches
+	 * instead of updating the segment's own render state.
+	 *
+	 * @warning An assertion is triggered if instanced rendering is already enabled.
+	 */
+	void EnableInstancedRendering(UInstancedSegmentRenderer* Renderer);
+
+	/** Takes the wall segments back from the renderer, so that each segment renders itself again. Does nothing if instanced rendering is not enabled. */
+	void DisableInstancedRendering();
+
+	/**
+	 * Merges the wall segments into batches owned by the room, one per distinct mesh, for rooms whose walls are not expected to change.
+	 * A segment changed afterwards by AddDoor, RemoveDoor or ApplyDoorLayout is split back out of its batch and renders itself,
+	 * leaving every other segment merged. Calling this again merges the split segments back in.
+	 *
+	 * @note Does nothing while instanced rendering is enabled, since the segments are already batched by the dungeon's renderer.
+	 */
+	void FinalizeSegments();
+
+	/** Splits every merged segment back out, so that each segment renders itself again. Does nothing if the room is not finalized. */
+	void RestoreSegments();
+
+	/** Returns true if the room's segments were merged by FinalizeSegments. */
+	bool IsFinalized() const;
+
+	/**
+	 * Pairs every segment with a hidden companion, as spawning a room whose blueprint enables m_bUseDualSegments does.
+	 * Does nothing if the segments are already paired.
+	 */
+	void EnableDualSegments();
+
+	/** 
+	 * Replaces the stream driving the room's door and wall mesh choices.
+	 * Rooms given equal streams pick the same meshes for the same sequence of door changes.
+	 */
+	void SetRandomStream(const FRandomStream& RandomStream);
+
+	/** Returns the stream driving the room's door and wall mesh choices. */
+	const FRandomStream& GetRandomStream() const;
+
+	/** Returns the width of the room in tiles; the number of segments on the North and South walls. */
+	FNumberOfTiles GetWidth() const;
+
+	/** Returns the length of the room in tiles; the number of segments on the East and West walls. */
+	FNumberOfTiles GetLength() const;
+
 	/** Initializes the root and wall scene components. */
 	ADungeonRoom();
 
@@ -133,6 +266,61 @@ private:
 	UPROPERTY(EditAnywhere)
 	USegmentedWall* m_SouthWall;
 
+	/** 
+	 * The renderer drawing the wall segments when instanced rendering is enabled.
+	 * Null when each segment renders itself.
+	 */
+	UPROPERTY(Transient)
+	UInstancedSegmentRenderer* m_SegmentRenderer{ nullptr };
+
+	/**
+	 * The room's own renderer, holding the segments merged by FinalizeSegments.
+	 * Created on the first finalization and kept afterwards, so that pooled rooms reuse its batches.
+	 */
+	UPROPERTY(Transient)
+	UInstancedSegmentRenderer* m_MergedSegments{ nullptr };
+
+	bool m_bIsFinalized{ false };		// True between FinalizeSegments and RestoreSegments
+
+	/**
+	 * The locations of every door in the room.
+	 * Initialized from the blueprint's segment meshes, then kept up to date by AddDoor, RemoveDoor and ApplyDoorLayout.
+	 */
+	FDoorLayout m_DoorLayout;
+
+	FOnDoorChanged m_OnDoorChanged;	// Broadcast for every door added or removed
+
+	FRandomStream m_RandomStream;		// Drives every door and wall mesh choice, so that a seed reproduces the room's visuals
+
+	FDoorLayout m_DefaultDoorLayout;	// The doors placed in the blueprint; restored when the room is released to a pool
+
+	/**
+	 * When enabled, every segment is paired with a hidden component holding the segment's other mesh, so toggling a door
+	 * swaps which of the two is visible and collidable instead of changing a mesh. Intended for rooms whose doors toggle often.
+	 *
+	 * @note The pairs are only used while the segments render themselves; instanced rendering and finalization use the segments alone.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Doors")
+	bool m_bUseDualSegments{ false };
+
+	/** The door mesh chosen for every segment, indexed by GetSegmentSlot; null until the segment first holds a door. */
+	UPROPERTY(Transient)
+	TArray<UStaticMesh*> m_CachedDoorMeshes;
+
+	/** The wall mesh chosen for every segment, indexed by GetSegmentSlot; null until the segment first holds a wall. */
+	UPROPERTY(Transient)
+	TArray<UStaticMesh*> m_CachedWallMeshes;
+
+	/** The mesh the blueprint gives every segment, indexed by GetSegmentSlot; put back when the room is released to a pool. */
+	UPROPERTY(Transient)
+	TArray<UStaticMesh*> m_DefaultSegmentMeshes;
+
+	/** The hidden companion of every segment, indexed by GetSegmentSlot; empty unless m_bUseDualSegments is enabled. */
+	UPROPERTY(Transient)
+	TArray<UStaticMeshComponent*> m_CompanionSegments;
+
+	TBitArray<> m_IsCompanionShown;		// Set for every segment whose companion is the visible one, indexed by GetSegmentSlot
+
 	/** 
 	 * Creates and returns a SegmentedWall with the given name
 	 * Used to initialize the blueprint asset
@@ -162,9 +350,39 @@ private:
 	UPROPERTY(EditAnywhere, AssetRegistrySearchable)
 	int32 m_Length; 
 
+	/**
+	 * The relative likelihood of this room being selected over other rooms with the same specs.
+	 * A room with a weight of 2 is picked twice as often as a room with a weight of 1; a weight of 0 is never picked.
+	 * Used for weighted random selection and searchable in the Asset Registry.
+	 */
+	UPROPERTY(EditAnywhere, AssetRegistrySearchable, meta = (ClampMin = "0.0"))
+	float m_SelectionWeight{ 1.0f };
+
+	/**
+	 * Masks of the segments of each wall that cannot hold a door, such as those behind a pillar; bit i blocks segment i.
+	 * Searchable in the Asset Registry, so the database knows where a room can have doors without loading it.
+	 */
+	UPROPERTY(EditAnywhere, AssetRegistrySearchable, Category = "Doors")
+	int64 m_BlockedNorthSegments{ 0 };
+
+	UPROPERTY(EditAnywhere, AssetRegistrySearchable, Category = "Doors")
+	int64 m_BlockedSouthSegments{ 0 };
+
+	UPROPERTY(EditAnywhere, AssetRegistrySearchable, Category = "Doors")
+	int64 m_BlockedEastSegments{ 0 };
+
+	UPROPERTY(EditAnywhere, AssetRegistrySearchable, Category = "Doors")
+	int64 m_BlockedWestSegments{ 0 };
+
 	/** Ensures that the blueprint has door and wall meshes set. */
 	virtual void PostActorCreated() override;
 
+	/** Initializes the door layout once the walls have populated their segments. */
+	virtual void PostInitializeComponents() override;
+
+	/** Removes the wall segments from the segment renderer if instanced rendering is enabled. */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/* Returns the wall corresponding to the given direction. */
 	USegmentedWall* GetWall(const EDirection Direction) const;
 
@@ -173,9 +391,104 @@ private:
 	 */
 	void SetStaticMesh(const FWallLocation& WallSegmentToUpdate, UStaticMesh* NewMesh);
 
-	/** Returns a random static mesh from the provided array */
-	UStaticMesh* GetRandomMesh(TArray<UStaticMesh*> Meshes) const;
+	/** SetStaticMesh for a segment whose component and slot have already been looked up, such as by PlanDoorLayout. */
+	void SetStaticMesh(UStaticMeshComponent* Segment, int32 SegmentSlot, UStaticMesh* NewMesh);
+
+	/** Populates m_DoorLayout and m_DefaultDoorLayout by checking which segments use a door mesh. */
+	void InitializeDoorLayout();
+
+	/**
+	 * Prepares the room to be kept in a pool: clears every door listener, restores the blueprint's doors, disables instanced rendering
+	 * and restores merged segments, then detaches and hides the room and disables its collision.
+	 */
+	void Deactivate();
+
+	/** Makes a pooled room visible and collidable again at the given location. */
+	void Activate(const FVector& Location);
+
+	/** Returns a mask of the segments without a door on the given wall, leaving out blocked segments. */
+	FDoorLayout::FWallMask GetFreeSegments(const EDirection Direction) const;
+
+	/** Returns the position of the segment among the segments of every wall, counted in the order of FDoorLayout::WallDirections. */
+	int32 GetSegmentSlot(const FWallLocation& Location) const;
+
+	/**
+	 * Returns the door or wall mesh the segment displayed the last time it held one.
+	 * Picks a random mesh from the blueprint instead, advancing the given stream, if the segment has not held one yet.
+	 */
+	UStaticMesh* ChooseSegmentMesh(const FWallLocation& Location, bool bIsDoor, const FRandomStream& RandomStream) const;
+
+	/** ChooseSegmentMesh for a segment whose slot has already been looked up. */
+	UStaticMesh* ChooseSegmentMesh(int32 SegmentSlot, bool bIsDoor, const FRandomStream& RandomStream) const;
+
+	/** Remembers the mesh as the segment's door or wall mesh, so that toggling the door keeps the segment's look. */
+	void CacheSegmentMesh(const FWallLocation& Location, bool bIsDoor, UStaticMesh* Mesh);
+
+	/** CacheSegmentMesh for a segment whose slot has already been looked up. */
+	void CacheSegmentMesh(int32 SegmentSlot, bool bIsDoor, UStaticMesh* Mesh);
+
+	/** Resets the cached meshes to those currently displayed by the segments. */
+	void InitializeSegmentMeshCache();
+
+	/** Records the mesh every segment displays in m_DefaultSegmentMeshes. */
+	void InitializeDefaultSegmentMeshes();
+
+	/** Puts the blueprint's mesh back on every segment, so a reused room looks like a freshly spawned one whatever meshes its last use picked. */
+	void RestoreDefaultSegmentMeshes();
+
+	/** Creates the hidden companion of every segment for m_bUseDualSegments. */
+	void CreateCompanionSegments();
+
+	/** Moves the mesh of every visible companion back onto its segment, so that the segments alone display the room. */
+	void CollapseCompanionSegments();
+
+	/** A segment whose mesh changes, resolved so that applying the change needs no lookups. */
+	struct FSegmentChange
+	{
+		UStaticMeshComponent* Segment;		// the segment's component
+
+		int32 		      SegmentSlot;	// the segment's position as given by GetSegmentSlot
+
+		UStaticMesh* 	      Mesh;		// the mesh the segment displays once the change is applied
+
+		bool 		      bIsDoor;		// true if the segment holds a door once the change is applied
+	};
+
+	/** The segment meshes that change when moving from the room's current doors to a new layout. */
+	struct FDoorLayoutPlan
+	{
+		FDoorLayout 	Layout;			// the doors of the room once the plan is applied
+
+		FRandomStream 	RandomStream;		// the room's stream once every mesh of the plan has been chosen
+
+		TArray<FSegmentChange, TInlineAllocator<8>> SegmentChanges;	// every changed segment, in the order its mesh was chosen
+	};
+
+	/** Acquires or spawns a room of the spawn info's class with the spawn info's stream, leaving its doors to the caller. */
+	static ADungeonRoom* SpawnWithoutDoors(const FSpawnInfo& SpawnInfo, UWorld* World);
+
+	/**
+	 * Returns the layout with the doors of the spawn info added, or the spawn info's door layout if it has one.
+	 *
+	 * @warning An assertion is triggered if a door of the spawn info is already in the layout.
+	 */
+	static FDoorLayout AddSpawnDoors(FDoorLayout Layout, const FSpawnInfo& SpawnInfo);
+
+	/**
+	 * Chooses the meshes needed to move from the current doors to the layout, drawing from the given stream; ApplyDoorLayout without the changes.
+	 * Only reads the room, so SpawnBatch plans its rooms on worker threads while the game thread waits.
+	 *
+	 * @warning An assertion is triggered under the same conditions as ApplyDoorLayout.
+	 */
+	void PlanDoorLayout(const FDoorLayout& Layout, const FRandomStream& RandomStream, FDoorLayoutPlan& OutPlan) const;
+
+	/** Sets the meshes of the plan, adopts its doors and stream, and notifies the door listeners. The plan must be made against the current doors. */
+	void ApplyDoorLayoutPlan(const FDoorLayoutPlan& Plan);
 
 	/* Requires access to the FNames of the AssetRegistrySearchable fields to enable searching for their values */
 	friend class FDungeonRoomAssetAnalyzer;
+	friend class FDungeonRoomAssetTags;
+
+	/* Activates and deactivates the rooms it pools */
+	friend class UDungeonRoomPool;
 };
@@ -0,0 +1,34 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Reads the optional AssetRegistrySearchable tags of DungeonRoom assets without loading them.
+ * Complements FDungeonRoomAssetAnalyzer, which reads the tags every room asset is required to have (theme and dimensions).
+ *
+ * @note Assets saved before a tag existed do not have it; every getter falls back to the property's default value.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/Enums/Direction.h"
+#include "Dungeon/Rooms/DoorLayout.h"
+
+#include "AssetRegistry/AssetData.h"
+
+class ARPG_API FDungeonRoomAssetTags
+{
+public:
+	/** Returns the designer-controlled weight used when randomly selecting between rooms with the same specs. */
+	static float GetSelectionWeight(const FAssetData& Asset);
+
+	/** Returns the mask of the segments of the given wall that cannot hold a door. */
+	static FDoorLayout::FWallMask GetBlockedSegments(const FAssetData& Asset, const EDirection Wall);
+
+	/**
+	 * Returns the segments of every wall that can hold a door: every segment of the wall, as given by the room's dimensions, that is not blocked.
+	 *
+	 * @param Width  - The number of segments on the North and South walls.
+	 * @param Length - The number of segments on the East and West walls.
+	 */
+	static FDoorLayout GetDoorSlots(const FAssetData& Asset, int32 Width, int32 Length);
+};
@@ -0,0 +1,107 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Spawns DungeonRooms from unloaded assets without blocking the game thread.
+ * Requested assets are streamed in as a single batch through an FStreamableManager, and the rooms are then spawned
+ * across as many frames as needed to stay within a configurable per-frame time budget.
+ *
+ * Batches are processed in the order they were requested; rooms within a batch are spawned in the order they were given.
+ *
+ * @note The spawner ticks itself while it has pending work; it must be created and used on the game thread.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/Rooms/DungeonRoom.h"
+
+#include "Async/Future.h"
+#include "Engine/StreamableManager.h"
+#include "Tickable.h"
+
+class ARPG_API FDungeonRoomAsyncSpawner : public FTickableGameObject
+{
+public:
+	/** Called once the room has been spawned; receives null if the asset failed to load. */
+	using FOnRoomSpawned = TFunction<void(ADungeonRoom*)>;
+
+	/** Called once every room of a batch has been processed. Rooms that failed to spawn are null. */
+	using FOnBatchSpawned = TFunction<void(const TArray<ADungeonRoom*>&)>;
+
+	/** Structure defining the information required to spawn a room from an asset that may not be loaded yet */
+	struct FAsyncSpawnInfo
+	{
+		FSoftObjectPath 			AssetPath;	// the asset to spawn
+
+		FVector 				RoomLocation;	// defines where to spawn the room
+
+		ADungeonRoom::FSpawnInfo::FDoorLocations DoorLocations;	// defines the locations of the doors
+
+		FRandomStream 				RandomStream{ FMath::Rand() };	// drives the room's mesh choices; randomly seeded unless set
+
+		FOnRoomSpawned 				OnSpawned;	// optional; invoked when this room has been spawned
+	};
+
+	/**
+	 * Creates a spawner for the given world.
+	 *
+	 * @param FrameBudgetSeconds - The time spent spawning rooms per frame. At least one room is spawned every frame regardless.
+	 */
+	FDungeonRoomAsyncSpawner(UWorld* World, double FrameBudgetSeconds = 0.002);
+
+	/** Completes every pending batch with the rooms spawned so far. */
+	virtual ~FDungeonRoomAsyncSpawner();
+
+	/**
+	 * Streams in the assets of every request and spawns the rooms across frames.
+	 *
+	 * @return A future that is fulfilled with the spawned rooms, in request order, once the whole batch has been processed.
+	 */
+	TFuture<TArray<ADungeonRoom*>> SpawnRooms(TArray<FAsyncSpawnInfo> SpawnInfos, FOnBatchSpawned OnBatchSpawned = nullptr);
+
+	/** Sets the time spent spawning rooms per frame. */
+	void SetFrameBudget(double FrameBudgetSeconds);
+
+	/** Returns true if there are no batches waiting to be loaded or spawned. */
+	bool IsIdle() const;
+
+	/** Stops every pending batch, completing each with the rooms spawned so far. */
+	void CancelAll();
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+private:
+	/** A group of rooms requested together, loaded as one streaming request. */
+	struct FSpawnBatch
+	{
+		TArray<FAsyncSpawnInfo> 	SpawnInfos;		// the rooms to spawn, in order
+
+		TArray<ADungeonRoom*> 		SpawnedRooms;		// the rooms spawned so far, in order
+
+		TSharedPtr<FStreamableHandle> 	LoadHandle;		// keeps the batch's assets loaded until every room is spawned
+
+		TPromise<TArray<ADungeonRoom*>> Promise;		// fulfilled once every room has been processed
+
+		FOnBatchSpawned 		OnBatchSpawned;		// optional; invoked once every room has been processed
+	};
+
+	TArray<TUniquePtr<FSpawnBatch>> m_Batches;			// Pending batches, oldest first
+
+	FStreamableManager 		m_StreamableManager;		// Streams in the assets of every batch
+
+	TWeakObjectPtr<UWorld> 		m_World;			// The world rooms are spawned in
+
+	double 				m_FrameBudgetSeconds;		// The time spent spawning rooms per frame
+
+	/** Spawns the next room of the batch, notifying its callback. */
+	void SpawnNextRoom(FSpawnBatch& Batch);
+
+	/** Fulfills the batch's future and notifies its callback. */
+	static void CompleteBatch(FSpawnBatch& Batch);
+};
@@ -5,6 +5,17 @@
  * Description: This class supports procedurally generating dungeons by providing information about the specifications of the available DungeonRoom assets.
  * The database supports querying for assets based on given specifications and can provide information about rooms of a specified theme, enabling the creation of thematic dungeons.
  * 
+ * The built index can be saved as a compact binary snapshot, typically by running UDungeonRoomDatabaseCommandlet as part of the cook.
+ * Cooked builds load the snapshot in a single read and only fall back to scanning the Asset Registry if it is missing or out of date.
+ * 
+ * In the editor, the database listens to the Asset Registry and patches itself as room assets in its path are added, removed, renamed or saved.
+ * Derived data (per-theme maxima, sorted indices, alias tables and asset indices) is recomputed lazily on the next query that needs it.
+ * 
+ * Thread safety: every const method may be called concurrently from any number of threads. Lazily recomputed data is
+ * rebuilt under a lock by the first reader that needs it; call PrepareForConcurrentReads() beforehand to keep workers from waiting on it.
+ * The database must not be modified while it is being read from other threads. Modifications only come from the
+ * Asset Registry callbacks in the editor, which run on the game thread, so a concurrent read must complete before the game thread resumes.
+ * 
  */
 
 #pragma once
@@ -13,49 +24,295 @@
 #include "Dungeon/Enums/DungeonTheme.h"
 #include "Dungeon/Structs/DungeonRoomSpecs.h"
 #include "Dungeon/SizeTypes/NumberOfTiles.h"
+#include "Dungeon/Enums/Direction.h"
+#include "Dungeon/Rooms/DoorLayout.h"
+#include "System/AliasTable.h"
+
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
 
 class ARPG_API FDungeonRoomDatabase
 {
 public:
-	/** Creates a database using the room assets inside of the given path. */
+	/** Non-owning views into the paths stored by the database; only valid for the lifetime of the database. */
+	using FAssetPathViews = TArray<TArrayView<const FSoftObjectPath>, TInlineAllocator<8>>;
+
+	/** 
+	 * Creates a database using the room assets inside of the given path.
+	 * Cooked builds load the path's snapshot if one exists; the Asset Registry is scanned otherwise.
+	 */
 	FDungeonRoomDatabase(FName PathToAssets);
 
+	/** Stops listening to the Asset Registry. */
+	~FDungeonRoomDatabase();
+
+	/** The database registers itself with the Asset Registry, so it cannot be copied or moved. */
+	FDungeonRoomDatabase(const FDungeonRoomDatabase&) = delete;
+	FDungeonRoomDatabase& operator=(const FDungeonRoomDatabase&) = delete;
+
+	/**
+	 * Writes the database to a binary snapshot that can be loaded in place of scanning the Asset Registry.
+	 * Blueprint paths are written as the paths of their generated classes, which is what cooked builds, the only ones loading snapshots, resolve.
+	 *
+	 * @return True if the file was written.
+	 */
+	bool SaveSnapshot(const FString& FilePath) const;
+
+	/** Returns the file the snapshot for the given path is saved to and loaded from. */
+	static FString GetSnapshotFilePath(FName PathToAssets);
+
+	/**
+	 * Recomputes any lazily derived data that is out of date, so that following reads never need to rebuild it.
+	 * Intended to be called on the game thread before handing the database to worker threads.
+	 */
+	void PrepareForConcurrentReads() const;
+
+	/** Returns the number of assets in the database. */
+	int32 GetNumAssets() const;
+
+	/**
+	 * Returns the index of the asset with the given path, or INDEX_NONE if it is not in the database.
+	 * Indices are assigned in order of path, so databases holding the same assets agree on every index, such as on a server and its clients.
+	 *
+	 * @note Indices change whenever an asset is added or removed.
+	 */
+	int32 GetAssetIndex(const FSoftObjectPath& Path) const;
+
+	/** Returns the path of the asset with the given index, or null if the index is out of range; see GetAssetIndex. */
+	const FSoftObjectPath* FindAssetPath(int32 AssetIndex) const;
+
+	/**
+	 * Returns the estimated memory cost of the asset once loaded: its class along with every door and wall mesh its rooms can pick from.
+	 * Recorded by MeasureAssetSizes, typically when the snapshot is built at cook time, and saved with the snapshot.
+	 *
+	 * @return 0 if the asset is not in the database or its size has not been measured.
+	 * @note Meshes shared between assets are counted once per asset.
+	 */
+	int64 GetEstimatedAssetSize(const FSoftObjectPath& Path) const;
+
+	/**
+	 * Loads every asset in the database and records its estimated size; see GetEstimatedAssetSize.
+	 * Intended for UDungeonRoomDatabaseCommandlet, so that cooked builds read the sizes from the snapshot rather than loading every room.
+	 *
+	 * @note Every room asset is loaded synchronously.
+	 */
+	void MeasureAssetSizes();
+
+	/** Returns the estimated size of the loaded room asset along with the door and wall meshes its rooms can pick from, or 0 if it is not a room. */
+	static int64 MeasureAssetSize(UObject* LoadedAsset);
+
+	/** Returns the number of bytes allocated by the database's maps and indices, including its lazily derived data. */
+	SIZE_T GetAllocatedSize() const;
+
+	/** Returns the specs of the asset, or null if the asset is not in the database. */
+	const FDungeonRoomSpecs* FindRoomSpecs(const FSoftObjectPath& Path) const;
+
+	/**
+	 * Returns the segments of every wall of the asset that can hold a door, or null if the asset is not in the database.
+	 * Read from the asset's tags, so it is known without loading the asset; see ADungeonRoom::GetDoorSlots.
+	 */
+	const FDoorLayout* FindDoorSlots(const FSoftObjectPath& Path) const;
+
+	/**
+	 * Adds the path of every asset with the given specs that can hold every door of the given layout to OutPaths, in the order of GetAssetPaths.
+	 * Intended to filter candidates by their required connections before any of them is loaded.
+	 */
+	void GetAssetPathsAllowingDoors(const FDungeonRoomSpecs& RoomSpecs, const FDoorLayout& Doors, TArray<FSoftObjectPath>& OutPaths) const;
+
 	/** Returns true if there is at least one asset in the database with the given specs. */
 	bool DoesAssetExistWithSpecs(const FDungeonRoomSpecs& Specs) const;
 
+	/** Adds the specs of every set of rooms with the given theme to OutSpecs, each exactly once. */
+	void GetRoomSpecs(EDungeonTheme Theme, TArray<FDungeonRoomSpecs>& OutSpecs) const;
+
 	/**
-	 * Provides paths to assets that have the given specs.
+	 * Provides paths to assets that have the given specs, ordered by path.
 	 *
 	 * @warning An assertion is triggered if there are no assets with the given specs; Can verfiy using DoesAssetExistWithSpecs().
 	 * @note Uncooked assets resolve to UBlueprint; Cooked assets resolve to UBlueprintGeneratedClass.
 	 */
 	const TArray<FSoftObjectPath>& GetAssetPaths(const FDungeonRoomSpecs& RoomSpecs) const;
 
+	/**
+	 * Randomly selects the path to an asset with the given specs, weighted by each room's selection weight.
+	 * Runs in constant time using an alias table precomputed for every set of specs.
+	 *
+	 * @warning An assertion is triggered if there are no assets with the given specs; Can verfiy using DoesAssetExistWithSpecs().
+	 * @note The result depends only on the database's contents and the stream's state, so seeded streams give reproducible picks.
+	 */
+	const FSoftObjectPath& SampleAssetPath(const FDungeonRoomSpecs& RoomSpecs, const FRandomStream& RandomStream) const;
+
+	/**
+	 * Randomly selects the path to an asset with the given specs that can hold every door of the given layout, weighted as SampleAssetPath is.
+	 * When every asset with the specs can hold the doors, the pick is exactly that of SampleAssetPath.
+	 *
+	 * @return Null if no asset with the given specs can hold the doors.
+	 * @note Runs in O(N), where N is the number of assets with the given specs, unless every one of them can hold the doors.
+	 */
+	const FSoftObjectPath* SampleAssetPathAllowingDoors(const FDungeonRoomSpecs& RoomSpecs, const FDoorLayout& Doors, const FRandomStream& RandomStream) const;
+
 	/** Returns the maximum width of rooms with the given theme. */
 	FNumberOfTiles GetMaxWidth(EDungeonTheme Theme) const;
 	
 	/** Returns the maximum length of rooms with the given theme. */
 	FNumberOfTiles GetMaxLength(EDungeonTheme Theme) const;
+
+	/**
+	 * Provides the paths to every asset of the given theme with a width of at most MaxWidth and a length of at most MaxLength.
+	 * Each view holds the fitting assets of a single width, ordered by length.
+	 *
+	 * @note Runs in O(W log N), where W is the number of distinct widths that fit and N is the number of assets of the theme.
+	 */
+	FAssetPathViews GetAssetPathsFitting(EDungeonTheme Theme, FNumberOfTiles MaxWidth, FNumberOfTiles MaxLength) const;
+
+	/**
+	 * Provides the paths to the assets of the given theme with the largest area that fits within MaxWidth by MaxLength.
+	 * Ties are broken in favour of the wider room.
+	 *
+	 * @return An empty view if no asset fits.
+	 */
+	TArrayView<const FSoftObjectPath> GetLargestAssetPathsFitting(EDungeonTheme Theme, FNumberOfTiles MaxWidth, FNumberOfTiles MaxLength) const;
+
+	/**
+	 * Provides the paths to every asset of the given theme with at least MinDoorSlots segments on the given side that can hold a door.
+	 * Counted from the same door slots as FindDoorSlots, so segments blocked by the asset are not included.
+	 * The paths are ordered by their number of door slots on that side.
+	 *
+	 * @note Runs in O(log N), where N is the number of assets of the theme.
+	 */
+	TArrayView<const FSoftObjectPath> GetAssetPathsWithDoorSlots(EDungeonTheme Theme, EDirection Side, FNumberOfTiles MinDoorSlots) const;
 	
 	
 private:
+	/** The assets of a single theme, sorted to support range and best-fit queries. */
+	struct FThemeIndex
+	{
+		TArray<FSoftObjectPath>  PathsByWidth;		// sorted by width, then length
+
+		TArray<FIntPoint> 	 DimensionsByWidth;	// the (width, length) of each entry in PathsByWidth
+
+		TArray<FSoftObjectPath>  PathsByLength;		// sorted by length, then width
+
+		TArray<FIntPoint> 	 DimensionsByLength;	// the (length, width) of each entry in PathsByLength
+
+		TArray<FSoftObjectPath>  PathsByDoorSlots[FDoorLayout::NumWalls];	// per wall, sorted by the number of door slots on that wall, then path
+
+		TArray<int32> 		 NumDoorSlots[FDoorLayout::NumWalls];		// per wall, the number of door slots of each entry in PathsByDoorSlots
+	};
+
+	/** The information the database keeps about a single room asset, extracted from its Asset Registry tags. */
+	struct FRoomAssetRecord
+	{
+		FSoftObjectPath   Path;			// path to the asset
+
+		FDungeonRoomSpecs Specs;		// the specs of the room
+
+		float 		  Weight{ 1.0f };	// the room's selection weight
+
+		FDoorLayout 	  DoorSlots;		// the segments of every wall that can hold a door
+
+		int64 		  EstimatedSize{ 0 };	// the size of the asset and the meshes it references; see GetEstimatedAssetSize
+	};
+
+	FName 						 m_PathToAssets;		     // The path the database was built from
+
 	TMap<FDungeonRoomSpecs, TArray<FSoftObjectPath>> m_PathsByRoomSpecs;		     // Maps room specs to paths to assets that have those specs
 
-	TMap<EDungeonTheme, FNumberOfTiles>	         m_MaxWidthByTheme;		     // Maps theme to the maximum width of rooms with that theme
+	TMap<FSoftObjectPath, FRoomAssetRecord>		 m_RecordsByPath;		     // Maps the path of every asset to its record
+
+	mutable TMap<EDungeonTheme, FNumberOfTiles>	 m_MaxWidthByTheme;		     // Maps theme to the maximum width of rooms with that theme
 	 
-	TMap<EDungeonTheme, FNumberOfTiles>	         m_MaxLengthByTheme;	             // Maps theme to the maximum length of rooms with that theme
+	mutable TMap<EDungeonTheme, FNumberOfTiles>	 m_MaxLengthByTheme;	             // Maps theme to the maximum length of rooms with that theme
+
+	mutable TSet<EDungeonTheme>			 m_ThemesWithStaleMaxima;	     // Themes whose maxima must be recomputed before they are queried
+
+	mutable TMap<EDungeonTheme, FThemeIndex>	 m_IndexByTheme;		     // Maps theme to its sorted index; derived from m_PathsByRoomSpecs
+
+	mutable TMap<FDungeonRoomSpecs, FAliasTable>	 m_AliasTablesBySpecs;		     // Maps room specs to an alias table over the weights of their paths, in order
+
+	mutable TArray<FSoftObjectPath> 		 m_PathsByAssetIndex;		     // The path of every asset, sorted; the position of a path is its asset index
+
+	mutable TMap<FSoftObjectPath, int32> 		 m_AssetIndexByPath;		     // Maps the path of every asset to its asset index
+
+	mutable std::atomic<bool> 			 m_bIsDerivedDataStale{ false };     // True if the indices and alias tables must be rebuilt before they are queried
+
+	mutable std::atomic<bool> 			 m_bHasStaleMaxima{ false };	     // True if m_ThemesWithStaleMaxima is not empty
+
+	mutable FCriticalSection 			 m_DerivedDataLock;		     // Held while the lazily derived data is rebuilt
 
 
 	/** Adds every asset in the given path to the database */
 	void InitializeDatabase(FName Path);
 
+	/**
+	 * Replaces the contents of the database with the snapshot stored in the given file.
+	 *
+	 * @return True if the snapshot was loaded; false if the file is missing, malformed or from an older version.
+	 */
+	bool LoadSnapshot(const FString& FilePath);
+
+	/** Reads or writes a single record of a snapshot, depending on the direction of the archive. */
+	static void SerializeRecord(FArchive& Archive, FRoomAssetRecord& Record);
+
+	/** Rebuilds every structure derived from m_PathsByRoomSpecs. */
+	void BuildDerivedData() const;
+
+	/** Rebuilds m_IndexByTheme from m_PathsByRoomSpecs. */
+	void BuildThemeIndices() const;
+
+	/** Rebuilds m_AliasTablesBySpecs from m_PathsByRoomSpecs and the weights of the records. */
+	void BuildAliasTables() const;
+
+	/** Rebuilds m_PathsByAssetIndex and m_AssetIndexByPath from the records. */
+	void BuildAssetIndices() const;
+
+	/** Extracts the record of the provided asset; parses the asset's tags exactly once. */
+	static FRoomAssetRecord ExtractRecord(const FAssetData& Asset);
+
+	/** 
+	 * Updates the mappings to include every provided asset.
+	 * Tags are extracted in parallel, then merged into maps that are reserved up front.
+	 */
+	void AddAssetsToDatabase(TConstArrayView<FAssetData> Assets);
+
+	/** Merges the records into maps that are reserved up front. */
+	void AddRecordsToDatabase(TArray<FRoomAssetRecord> Records);
+
 	/** Updates the mappings to include the provided asset */
 	void AddAssetToDatabase(const FAssetData& Asset);
 
-	/** Updates the max width and length maps to include the asset */
-	void UpdateMaxWidthAndLengthMaps(const FAssetData& Asset);
+	/** Updates the paths and max width and length maps to include the record */
+	void AddRecordToDatabase(const FRoomAssetRecord& Record);
+
+	/** Removes the asset with the given path from the mappings, marking the derived data it affects as stale. */
+	void RemovePathFromDatabase(const FSoftObjectPath& Path);
+
+	/** Recomputes the maxima of every theme that lost a room defining one of its maxima. */
+	void RefreshStaleMaxima() const;
+
+	/** Rebuilds the derived data if assets were added or removed since it was built. */
+	void RefreshStaleDerivedData() const;
+
+#if WITH_EDITOR
+	FDelegateHandle m_OnAssetAddedHandle;
+	FDelegateHandle m_OnAssetRemovedHandle;
+	FDelegateHandle m_OnAssetRenamedHandle;
+	FDelegateHandle m_OnAssetUpdatedHandle;
+
+	/** Starts patching the database whenever the Asset Registry reports a change. */
+	void SubscribeToAssetRegistry();
+
+	/** Stops patching the database. */
+	void UnsubscribeFromAssetRegistry();
+
+	/** Returns true if the asset is a DungeonRoom blueprint inside of the database's path. */
+	bool IsRoomAssetInPath(const FAssetData& Asset) const;
 
-	/** Updates the paths map to include the asset */
-	void UpdateAssetPathsMap(const FAssetData& Asset);
+	void OnAssetAdded(const FAssetData& Asset);
+	void OnAssetRemoved(const FAssetData& Asset);
+	void OnAssetRenamed(const FAssetData& Asset, const FString& OldObjectPath);
+	void OnAssetUpdated(const FAssetData& Asset);
+#endif
 
 };
@@ -0,0 +1,26 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Builds the room database for a content path and writes it to the snapshot loaded by cooked builds.
+ * Intended to run as a step of the cook, before staging, so the snapshot always matches the cooked room assets.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=DungeonRoomDatabase -Path=/Game/Dungeon/Rooms
+ *
+ * @note The snapshot is written to Content/DungeonRoomDatabase, which Config/DefaultGame.ini stages into the pak through DirectoriesToAlwaysStageAsUFS.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DungeonRoomDatabaseCommandlet.generated.h"
+
+UCLASS()
+class ARPG_API UDungeonRoomDatabaseCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns 0 if the snapshot was written, 1 otherwise. */
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,120 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: An adjacency graph of the rooms of a dungeon, where every pair of facing doors forms an edge.
+ * Edges are added and removed incrementally as doors change, and the graph answers connectivity and distance queries.
+ *
+ * Connectivity is tracked with a union-find structure. Connecting rooms merges their sets immediately; removing an edge
+ * only marks the sets as stale, and they are rebuilt from the edge list on the next connectivity query.
+ *
+ * @note Rooms are identified by their index within the owning dungeon.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/Enums/Direction.h"
+
+/** A single door, identified by the room it belongs to and its location within that room. */
+struct FRoomDoor
+{
+	int32 	   RoomIndex{ INDEX_NONE };
+
+	EDirection Wall;
+
+	int32 	   SegmentIndex{ 0 };
+
+	bool operator==(const FRoomDoor& Other) const
+	{
+		return RoomIndex == Other.RoomIndex && Wall == Other.Wall && SegmentIndex == Other.SegmentIndex;
+	}
+
+	friend uint32 GetTypeHash(const FRoomDoor& Door)
+	{
+		return HashCombineFast(HashCombineFast(::GetTypeHash(Door.RoomIndex), ::GetTypeHash(static_cast<uint8>(Door.Wall))), ::GetTypeHash(Door.SegmentIndex));
+	}
+};
+
+class ARPG_API FDungeonRoomGraph
+{
+public:
+	/** An edge between two rooms, formed by a pair of facing doors. */
+	struct FRoomEdge
+	{
+		FRoomDoor Doors[2];
+	};
+
+	/** Adds a room without any edges; rooms must be added in index order. */
+	void AddRoom(int32 RoomIndex);
+
+	/** Returns the number of rooms in the graph. */
+	int32 GetNumRooms() const;
+
+	/** Returns the number of edges in the graph. */
+	int32 GetNumEdges() const;
+
+	/**
+	 * Adds an edge between the rooms of the two facing doors.
+	 *
+	 * @warning An assertion is triggered if either door is already part of an edge.
+	 */
+	void Connect(const FRoomDoor& Door, const FRoomDoor& FacingDoor);
+
+	/** Removes the edge formed by the given door, if there is one. */
+	void Disconnect(const FRoomDoor& Door);
+
+	/** Returns true if the door forms an edge with a facing door. */
+	bool IsConnected(const FRoomDoor& Door) const;
+
+	/** Returns the indices of the rooms directly connected to the given room; a room appears once per edge. */
+	void GetNeighbors(int32 RoomIndex, TArray<int32>& OutNeighborIndices) const;
+
+	/** Returns true if there is a path between the two rooms. */
+	bool AreConnected(int32 RoomA, int32 RoomB) const;
+
+	/** Returns the number of groups of rooms that are connected to each other but not to any other room. */
+	int32 GetNumComponents() const;
+
+	/** Returns true if every room can be reached from every other room. */
+	bool IsFullyConnected() const;
+
+	/** Returns true if there is more than one path between at least one pair of rooms. */
+	bool HasLoop() const;
+
+	/** Returns the number of edges on the shortest path between the two rooms, or INDEX_NONE if they are not connected. */
+	int32 GetDistance(int32 RoomA, int32 RoomB) const;
+
+	/** Fills OutDistances with the number of edges from the source to each room, or INDEX_NONE for unreachable rooms. */
+	void GetDistances(int32 SourceRoom, TArray<int32>& OutDistances) const;
+
+	/** Fills OutDistances with the number of edges from the nearest source to each room, or INDEX_NONE for rooms no source can reach. */
+	void GetDistances(TConstArrayView<int32> SourceRooms, TArray<int32>& OutDistances) const;
+
+	/** Removes every room and edge. */
+	void Reset();
+
+	/** Returns the number of bytes allocated by the graph, including the edge lists of rooms with more than a few edges. */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	TSparseArray<FRoomEdge> 		       m_Edges;		    // Every edge of the graph
+
+	TMap<FRoomDoor, int32> 	 		       m_EdgeIndexByDoor;   // Maps both doors of every edge to the edge's index
+
+	TArray<TArray<int32, TInlineAllocator<4>>>     m_EdgesByRoom;	    // The indices of the edges touching each room
+
+	mutable TArray<int32> 			       m_Parents;	    // The union-find parent of each room
+
+	mutable int32 				       m_NumComponents{ 0 }; // The number of disjoint sets in m_Parents
+
+	mutable bool 				       m_bIsConnectivityStale{ false }; // True if m_Parents must be rebuilt after an edge was removed
+
+	/** Returns the representative of the room's set, compressing the path to it. */
+	int32 FindRoot(int32 RoomIndex) const;
+
+	/** Merges the sets of the two rooms. */
+	void Union(int32 RoomA, int32 RoomB) const;
+
+	/** Rebuilds the union-find sets from the edge list if an edge was removed since they were built. */
+	void RefreshConnectivity() const;
+};
@@ -0,0 +1,61 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Keeps DungeonRooms that are no longer in use so they can be reused rather than destroyed and spawned again.
+ * Rooms are pooled per blueprint class; ADungeonRoom::Spawn takes a room from the pool of the requested class before spawning a new actor.
+ *
+ * Released rooms have their doors restored to the blueprint's layout, are detached and hidden, and have collision disabled.
+ * Reusing a room skips actor construction, component creation and registration, and the garbage collection of the old room.
+ *
+ * @note There is one pool per world; pooled rooms are destroyed along with their world.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Subsystems/WorldSubsystem.h"
+#include "DungeonRoomPool.generated.h"
+
+class ADungeonRoom;
+
+/** The pooled rooms of a single blueprint class. */
+USTRUCT()
+struct FPooledDungeonRooms
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<ADungeonRoom*> Rooms;
+};
+
+UCLASS()
+class ARPG_API UDungeonRoomPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Takes a room of the given class from the pool and activates it at the given location.
+	 *
+	 * @return Null if there is no pooled room of the class.
+	 */
+	ADungeonRoom* Acquire(UClass* RoomClass, const FVector& Location);
+
+	/**
+	 * Deactivates the room and keeps it for reuse.
+	 *
+	 * @warning An assertion is triggered if the room is already in the pool.
+	 */
+	void Release(ADungeonRoom* Room);
+
+	/** Returns the number of pooled rooms of the given class. */
+	int32 GetNumPooledRooms(UClass* RoomClass) const;
+
+	/** Destroys every pooled room. */
+	void Empty();
+
+private:
+	/** Maps a blueprint class to its pooled rooms. */
+	UPROPERTY(Transient)
+	TMap<UClass*, FPooledDungeonRooms> m_RoomsByClass;
+};
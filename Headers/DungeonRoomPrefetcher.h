@@ -0,0 +1,125 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Streams in the room assets of an upcoming floor while the player is still on the current one,
+ * so that spawning the floor does not wait on loads. Candidates come from an FDungeonRoomDatabase by theme, or from
+ * a pre-generated layout when one is known, in which case the layout's assets are requested first.
+ *
+ * Assets are requested at a priority below the default, a few at a time, and stay loaded for as long as the prefetcher
+ * holds their handle. Once the loaded assets exceed the memory budget, the least recently used assets of earlier floors
+ * are released; if the current floor's assets alone fill the budget, the remaining ones are left to load on demand.
+ *
+ * @note Sizes are estimated from the room class and the door and wall meshes it references once it has loaded. Meshes
+ *       shared between assets are counted once per asset, so the budget errs on the side of releasing too much.
+ * @note The prefetcher must be created and used on the game thread.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/Rooms/DungeonRoomDatabase.h"
+#include "Dungeon/DungeonLayout.h"
+
+#include "Engine/StreamableManager.h"
+
+class ARPG_API FDungeonRoomPrefetcher
+{
+public:
+	/** The priority prefetches are requested at; below the default so that loads needed right away go first. */
+	static constexpr TAsyncLoadPriority PrefetchPriority{ FStreamableManager::DefaultAsyncLoadPriority - 1 };
+
+	/**
+	 * Creates a prefetcher drawing candidates from the given database.
+	 *
+	 * @param MemoryBudgetBytes - The estimated size of assets kept loaded before the least recently used are released.
+	 * @param MaxLoadsInFlight  - The number of assets being streamed in at once; bounds how far a burst of loads can overshoot the budget.
+	 * @warning An assertion is triggered if the database is null.
+	 */
+	FDungeonRoomPrefetcher(TSharedPtr<const FDungeonRoomDatabase> Database, int64 MemoryBudgetBytes, int32 MaxLoadsInFlight = 4);
+
+	/** Cancels every pending load and releases every prefetched asset. */
+	~FDungeonRoomPrefetcher();
+
+	/** Load callbacks refer to the prefetcher, so it cannot be copied or moved. */
+	FDungeonRoomPrefetcher(const FDungeonRoomPrefetcher&) = delete;
+	FDungeonRoomPrefetcher& operator=(const FDungeonRoomPrefetcher&) = delete;
+
+	/**
+	 * Queues every asset of the given theme, replacing anything queued but not yet requested.
+	 * When the next floor's layout is known, its assets are queued ahead of the rest of the theme, in the layout's order.
+	 *
+	 * @note Assets already loaded or loading are kept and count as used.
+	 */
+	void PrefetchFloor(EDungeonTheme Theme, const FDungeonLayout* Layout = nullptr);
+
+	/** Queues the assets of the layout, replacing anything queued but not yet requested. */
+	void PrefetchLayout(const FDungeonLayout& Layout);
+
+	/** Marks the asset as used, such as when a room is spawned from it, so that it is the last to be released. Does nothing if it was not prefetched. */
+	void MarkUsed(const FSoftObjectPath& AssetPath);
+
+	/** Returns true if the asset was prefetched and has finished loading. */
+	bool IsLoaded(const FSoftObjectPath& AssetPath) const;
+
+	/** Sets the memory budget, releasing the least recently used assets until the loaded assets fit. */
+	void SetMemoryBudget(int64 MemoryBudgetBytes);
+
+	/** Returns the estimated size of every prefetched asset that has finished loading. */
+	int64 GetLoadedBytes() const;
+
+	/** Returns the number of assets waiting to be requested. */
+	int32 GetNumQueued() const;
+
+	/** Cancels every pending load and releases every prefetched asset. */
+	void Reset();
+
+private:
+	/** An asset requested by the prefetcher. */
+	struct FPrefetchEntry
+	{
+		TSharedPtr<FStreamableHandle> Handle;		// keeps the asset loaded
+
+		int64 			      SizeBytes{ 0 };	// the estimated size of the asset; 0 until it has loaded
+
+		uint64 			      LastUsed{ 0 };	// the value of m_UseCounter when the asset was last used
+
+		bool 			      bIsLoaded{ false };// true once the asset has finished loading
+	};
+
+	TSharedPtr<const FDungeonRoomDatabase> 	 m_Database;		// Provides the candidates of a theme
+
+	TMap<FSoftObjectPath, FPrefetchEntry> 	 m_Entries;		// Maps every requested asset to its entry
+
+	TArray<FSoftObjectPath> 		 m_Queue;		// Assets waiting to be requested; the next to request is last
+
+	int64 					 m_MemoryBudgetBytes;	// The estimated size of assets kept loaded
+
+	int64 					 m_LoadedBytes{ 0 };	// The sum of the sizes of every loaded entry
+
+	int32 					 m_MaxLoadsInFlight;	// The number of requests issued at once
+
+	int32 					 m_NumLoadsInFlight{ 0 };// The number of requests that have not finished loading
+
+	uint64 					 m_UseCounter{ 0 };	// Incremented every time an asset is used; orders entries by recency
+
+	uint64 					 m_FloorStartUse{ 0 };	// The value of m_UseCounter when the current floor was queued
+
+	FStreamableManager 			 m_StreamableManager;	// Streams in the prefetched assets
+
+	/** Replaces the queue with the given paths, marking those already requested as used. */
+	void Enqueue(TConstArrayView<FSoftObjectPath> AssetPaths);
+
+	/** Requests queued assets until MaxLoadsInFlight are loading, or until the budget is filled by assets of the current floor. */
+	void RequestQueuedAssets();
+
+	/** Records the size of the loaded asset, then requests the next queued assets. */
+	void OnAssetLoaded(FSoftObjectPath AssetPath);
+
+	/**
+	 * Releases the least recently used loaded assets until the loaded assets fit within the budget.
+	 * Assets used at or after MinProtectedUse are kept, so that a floor's own assets never push each other out.
+	 *
+	 * @return True if the loaded assets fit within the budget.
+	 */
+	bool EvictToBudget(uint64 MinProtectedUse);
+};
@@ -0,0 +1,97 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Stores the door and footprint state of every room of a dungeon as a structure of arrays.
+ * Each property lives in its own contiguous array indexed by room, so whole-dungeon passes such as counting doors, finding dead ends
+ * or drawing a minimap are linear sweeps over plain integers rather than walks through each room's walls and components.
+ *
+ * Rooms are identified by the same indices as FDungeonTileGrid and FDungeonRoomGraph; the table holds the state of rooms
+ * whether or not their actors exist, so it remains the source of truth for rooms that are streamed out.
+ *
+ * @note Segment counts duplicate the footprint's dimensions, so that a sweep over one wall only reads that wall's two arrays.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/DungeonTileGrid.h"
+#include "Dungeon/Rooms/DoorLayout.h"
+
+class ARPG_API FDungeonRoomTable
+{
+public:
+	/** Describes the contents of a single minimap tile. */
+	enum class EMinimapTile : uint8
+	{
+		Empty,		// no room covers the tile
+		Floor,		// a room covers the tile
+		Door		// a room covers the tile and has a door on one of the tile's walls
+	};
+
+	/**
+	 * Appends a room with the given footprint and doors.
+	 *
+	 * @warning An assertion is triggered if the room's index is not the next index, or if the doors lie outside of the footprint's walls.
+	 */
+	void AddRoom(int32 RoomIndex, const FTileFootprint& Footprint, const FDoorLayout& Doors);
+
+	/** Returns the doors of the given room. */
+	FDoorLayout GetDoorLayout(int32 RoomIndex) const;
+
+	/** Replaces the doors of the given room. */
+	void SetDoorLayout(int32 RoomIndex, const FDoorLayout& Doors);
+
+	/** Adds or removes the door at the given segment of the given room. */
+	void SetDoor(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex, bool bHasDoor);
+
+	/** Returns true if the given room has a door at the given segment. */
+	bool HasDoor(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex) const;
+
+	/** Returns the footprint of the given room. */
+	FTileFootprint GetFootprint(int32 RoomIndex) const;
+
+	/** Returns the door mask of every room's given wall, ordered by room index. */
+	TConstArrayView<FDoorLayout::FWallMask> GetDoorMasks(const EDirection Wall) const;
+
+	/** Returns the number of segments of every room's given wall, ordered by room index. */
+	TConstArrayView<uint8> GetNumSegments(const EDirection Wall) const;
+
+	/** Returns the number of doors across every room. */
+	int32 GetNumDoors() const;
+
+	/** Returns the number of doors of the given room. */
+	int32 GetNumDoors(int32 RoomIndex) const;
+
+	/** Adds every room with exactly one door to OutRoomIndices, in index order. */
+	void FindDeadEnds(TArray<int32>& OutRoomIndices) const;
+
+	/** Returns the smallest rectangle of tiles containing every room; Max is exclusive. Empty if there are no rooms. */
+	FIntRect GetBounds() const;
+
+	/**
+	 * Draws every room into a tile image covering GetBounds(), one entry per tile in rows of increasing X.
+	 *
+	 * @param OutTiles - Receives Bounds.Width() * Bounds.Height() entries; the tile (X, Y) is at (X - Min.X) * Height + (Y - Min.Y).
+	 */
+	void RasterizeMinimap(TArray<EMinimapTile>& OutTiles, FIntRect& OutBounds) const;
+
+	/** Returns the number of rooms in the table. */
+	int32 Num() const;
+
+	/** Removes every room from the table. */
+	void Reset();
+
+	/** Returns the number of bytes allocated by the table's arrays. */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	TArray<FDoorLayout::FWallMask> m_DoorMasks[FDoorLayout::NumWalls];	// The door mask of every room, one array per wall ordered by wall index
+
+	TArray<uint8> 		       m_NumSegments[FDoorLayout::NumWalls];	// The segment count of every room, one array per wall ordered by wall index
+
+	TArray<FIntPoint> 	       m_Origins;				// The south-west tile of every room
+
+	TArray<int32> 		       m_Widths;				// The number of tiles along Y of every room
+
+	TArray<int32> 		       m_Lengths;				// The number of tiles along X of every room
+};
@@ -0,0 +1,52 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Declares the profiling surface of the dungeon: the "Dungeon" stat group and the "Dungeon" Unreal Insights trace channel.
+ * Cycle counters time the hot paths of spawning rooms, changing doors, initializing walls and building the room database; counters track
+ * how much work each frame did. Run "stat Dungeon" for an on-screen summary, or enable the channel with "-trace=cpu,Dungeon" for Insights.
+ *
+ * @note Everything declared here compiles out in shipping builds.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Stats/Stats.h"
+
+#if !UE_BUILD_SHIPPING
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+#endif
+
+DECLARE_STATS_GROUP(TEXT("Dungeon"), STATGROUP_Dungeon, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Room Spawn"), STAT_DungeonRoomSpawn, STATGROUP_Dungeon, ARPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Room Spawn Batch"), STAT_DungeonRoomSpawnBatch, STATGROUP_Dungeon, ARPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Room Add Door"), STAT_DungeonRoomAddDoor, STATGROUP_Dungeon, ARPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Room Remove Door"), STAT_DungeonRoomRemoveDoor, STATGROUP_Dungeon, ARPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Room Apply Door Layout"), STAT_DungeonRoomApplyDoorLayout, STATGROUP_Dungeon, ARPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Wall Initialize Segments"), STAT_DungeonWallInitializeSegments, STATGROUP_Dungeon, ARPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Database Initialize"), STAT_DungeonDatabaseInitialize, STATGROUP_Dungeon, ARPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Database Load Snapshot"), STAT_DungeonDatabaseLoadSnapshot, STATGROUP_Dungeon, ARPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dungeon Add Room"), STAT_DungeonAddRoom, STATGROUP_Dungeon, ARPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dungeon Spawn Layout"), STAT_DungeonSpawnLayout, STATGROUP_Dungeon, ARPG_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rooms Spawned"), STAT_DungeonRoomsSpawned, STATGROUP_Dungeon, ARPG_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Doors Changed"), STAT_DungeonDoorsChanged, STATGROUP_Dungeon, ARPG_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Meshes Swapped"), STAT_DungeonMeshesSwapped, STATGROUP_Dungeon, ARPG_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Assets Indexed"), STAT_DungeonAssetsIndexed, STATGROUP_Dungeon, ARPG_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Database Snapshot Bytes Read"), STAT_DungeonDatabaseSnapshotBytesRead, STATGROUP_Dungeon, ARPG_API);
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Prefetched Assets"), STAT_DungeonPrefetchedMemory, STATGROUP_Dungeon, ARPG_API);
+
+#if !UE_BUILD_SHIPPING
+UE_TRACE_CHANNEL_EXTERN(DungeonChannel, ARPG_API);
+
+/** Times the enclosing scope with the given cycle stat, and records it as an event on the Dungeon trace channel. */
+#define DUNGEON_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(#Stat, DungeonChannel)
+#else
+#define DUNGEON_SCOPE_CYCLE_COUNTER(Stat)
+#endif
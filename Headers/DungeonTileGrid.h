@@ -0,0 +1,122 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: A sparse grid recording which room occupies each tile of a dungeon.
+ * Supports constant-time point queries, box queries proportional to the area searched, and neighbor queries across room walls.
+ *
+ * Layout convention shared by every dungeon grid:
+ * 	- The X axis points North and the Y axis points East.
+ * 	- A room's footprint covers Length tiles along X and Width tiles along Y, starting at its origin (its south-west tile).
+ * 	- North and South walls run along Y, so segment i sits at Y = Origin.Y + i.
+ * 	- East and West walls run along X, so segment i sits at X = Origin.X + i.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/Enums/Direction.h"
+
+/** An axis-aligned rectangle of tiles occupied by a room. */
+struct FTileFootprint
+{
+	FIntPoint Origin{ 0, 0 };	// the south-west tile
+
+	int32 	  Width{ 0 };		// the number of tiles along Y
+
+	int32 	  Length{ 0 };		// the number of tiles along X
+
+	/** Returns the tile one past the north-east corner. */
+	FIntPoint GetEnd() const { return { Origin.X + Length, Origin.Y + Width }; }
+
+	/** Returns true if the tile lies within the footprint. */
+	bool Contains(const FIntPoint& Tile) const
+	{
+		return Tile.X >= Origin.X && Tile.X < Origin.X + Length && Tile.Y >= Origin.Y && Tile.Y < Origin.Y + Width;
+	}
+
+	/** Returns true if the footprints share at least one tile. */
+	bool Intersects(const FTileFootprint& Other) const
+	{
+		const FIntPoint End{ GetEnd() };
+		const FIntPoint OtherEnd{ Other.GetEnd() };
+		return Origin.X < OtherEnd.X && Other.Origin.X < End.X && Origin.Y < OtherEnd.Y && Other.Origin.Y < End.Y;
+	}
+
+	/** Returns the number of segments on the given wall. */
+	int32 GetNumSegments(const EDirection Wall) const
+	{
+		return Wall == EDirection::North || Wall == EDirection::South ? Width : Length;
+	}
+
+	/** Returns the tile inside the footprint that holds the given wall segment. */
+	FIntPoint GetSegmentTile(const EDirection Wall, const int32 SegmentIndex) const;
+
+	/** Returns the tile directly outside the footprint, across the given wall segment. */
+	FIntPoint GetTileAcrossSegment(const EDirection Wall, const int32 SegmentIndex) const;
+
+	/** Returns the index of the segment of the given wall that runs alongside the tile. The tile is assumed to lie along that wall. */
+	int32 GetSegmentIndexAt(const EDirection Wall, const FIntPoint& Tile) const
+	{
+		return Wall == EDirection::North || Wall == EDirection::South ? Tile.Y - Origin.Y : Tile.X - Origin.X;
+	}
+};
+
+class ARPG_API FDungeonTileGrid
+{
+public:
+	/** Returns the wall facing the given wall across a shared edge (North faces South, East faces West). */
+	static EDirection GetOppositeWall(const EDirection Wall);
+
+	/** Returns true if none of the footprint's tiles are occupied. */
+	bool IsAreaFree(const FTileFootprint& Footprint) const;
+
+	/**
+	 * Marks the footprint's tiles as occupied by the given room.
+	 *
+	 * @warning An assertion is triggered if the room is already in the grid or if the footprint overlaps another room.
+	 */
+	void AddRoom(int32 RoomIndex, const FTileFootprint& Footprint);
+
+	/** Frees the tiles occupied by the given room, if it is in the grid. */
+	void RemoveRoom(int32 RoomIndex);
+
+	/** Returns the footprint of the given room, or null if the room is not in the grid. */
+	const FTileFootprint* FindFootprint(int32 RoomIndex) const;
+
+	/** Returns the room occupying the tile, or INDEX_NONE if the tile is free. */
+	int32 FindRoomAt(const FIntPoint& Tile) const;
+
+	/** Adds every room overlapping the box to OutRoomIndices, each exactly once. */
+	void FindRoomsInBox(const FTileFootprint& Box, TArray<int32>& OutRoomIndices) const;
+
+	/** Returns the room on the other side of the given wall segment of a room, or INDEX_NONE if there is none. */
+	int32 FindNeighbor(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex) const;
+
+	/**
+	 * Returns the segment of the neighboring room that faces the given wall segment of a room.
+	 * The facing segment lies on the opposite wall of the neighbor, returned by FindNeighbor.
+	 *
+	 * @return The index of the facing segment, or INDEX_NONE if there is no room across the segment.
+	 */
+	int32 FindFacingSegment(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex) const;
+
+	/** Adds every room sharing a wall with the given room to OutRoomIndices, each exactly once. */
+	void FindNeighbors(int32 RoomIndex, TArray<int32>& OutRoomIndices) const;
+
+	/** Returns the number of rooms in the grid. */
+	int32 Num() const;
+
+	/** Preallocates room for the given number of rooms covering the given number of tiles in total. */
+	void Reserve(int32 NumRooms, int32 NumTiles);
+
+	/** Removes every room from the grid. */
+	void Reset();
+
+	/** Returns the number of bytes allocated by the grid's maps. */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	TMap<FIntPoint, int32>     m_RoomIndexByTile;	    // Maps every occupied tile to the room occupying it
+
+	TMap<int32, FTileFootprint> m_FootprintByRoomIndex; // Maps every room in the grid to its footprint
+};
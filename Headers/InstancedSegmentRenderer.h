@@ -0,0 +1,78 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Renders the wall segments of many rooms through shared instanced static mesh components.
+ * Every distinct segment mesh owns a single batch, so the number of render proxies scales with the number of meshes rather than the number of segments.
+ *
+ * Segments handed to the renderer are unregistered; their static mesh is still kept up to date so that the segment remains
+ * the source of truth for which mesh it displays.
+ *
+ * @note Collision is provided by the batches, using the collision profile of the first segment added to each batch.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "InstancedSegmentRenderer.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+
+UCLASS(ClassGroup = (Dungeon))
+class ARPG_API UInstancedSegmentRenderer : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	UInstancedSegmentRenderer();
+
+	/**
+	 * Hands the rendering of the segment over to the batch matching its current static mesh.
+	 *
+	 * @warning An assertion is triggered if the segment was already added.
+	 */
+	void AddSegment(UStaticMeshComponent* Segment);
+
+	/**
+	 * Moves the segment's instance into the batch matching the new mesh.
+	 *
+	 * @warning An assertion is triggered if the segment was not added to the renderer.
+	 */
+	void SetSegmentMesh(UStaticMeshComponent* Segment, UStaticMesh* NewMesh);
+
+	/**
+	 * Removes the segment's instance from its batch.
+	 *
+	 * @note The segment is left unregistered; register it again if it should render itself.
+	 */
+	void RemoveSegment(UStaticMeshComponent* Segment);
+
+	/** Returns true if the segment is currently rendered by this renderer. */
+	bool ContainsSegment(const UStaticMeshComponent* Segment) const;
+
+private:
+	/** A single instanced component along with the segments that own each of its instances. */
+	struct FInstanceBatch
+	{
+		UHierarchicalInstancedStaticMeshComponent* Component;	// renders every instance of the batch's mesh
+
+		TArray<UStaticMeshComponent*> Segments;			// the segment at index i owns instance i
+	};
+
+	TMap<UStaticMesh*, FInstanceBatch>       m_BatchesByMesh;		// Maps a mesh to the batch rendering it
+
+	TMap<const UStaticMeshComponent*, int32> m_InstanceIndexBySegment;	// Maps a segment to its instance within its mesh's batch
+
+	/** Keeps the batch components referenced for the lifetime of the renderer. */
+	UPROPERTY(Transient)
+	TArray<UHierarchicalInstancedStaticMeshComponent*> m_BatchComponents;
+
+	/** Returns the batch for the given mesh, creating it if it does not exist yet. */
+	FInstanceBatch& FindOrAddBatch(UStaticMesh* Mesh, const UStaticMeshComponent* Segment);
+
+	/** Adds an instance owned by the segment to the batch matching the segment's current mesh. */
+	void AddInstance(UStaticMeshComponent* Segment);
+
+	/** Removes the instance owned by the segment from the batch matching the segment's current mesh. */
+	void RemoveInstance(const UStaticMeshComponent* Segment);
+};
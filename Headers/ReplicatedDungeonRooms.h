@@ -0,0 +1,96 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: A compact, delta-replicated description of the rooms of a dungeon.
+ * Room actors are never replicated. Instead, each room is described by the index of its asset within a shared FDungeonRoomDatabase,
+ * its tile origin and its door bitsets; clients spawn the rooms locally from these descriptions.
+ *
+ * Rooms are replicated through an FFastArraySerializer, so once a client has the dungeon, only the rooms whose doors change are sent again.
+ * Each item is packed with variable-length integers: a few bytes for its indices and position, and usually one byte per wall for its doors.
+ *
+ * @note The server and its clients must hold databases with identical assets, such as those built from the same cooked content.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/Rooms/DoorLayout.h"
+
+#include "Net/Serialization/FastArraySerializer.h"
+#include "ReplicatedDungeonRooms.generated.h"
+
+class ADungeon;
+struct FReplicatedDungeonRoomArray;
+
+/** The replicated description of a single room. */
+USTRUCT()
+struct FReplicatedDungeonRoom : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 AssetIndex{ INDEX_NONE };	// the index of the room's asset within the database
+
+	UPROPERTY()
+	int32 LayoutIndex{ 0 };		// the index of the room within its layout; selects the room's random stream
+
+	UPROPERTY()
+	int16 TileX{ 0 };		// the room's origin tile, quantized to 16 bits
+
+	UPROPERTY()
+	int16 TileY{ 0 };
+
+	UPROPERTY()
+	uint64 DoorMasks[FDoorLayout::NumWalls]{ };	// the room's doors, ordered by wall index
+
+	/** Returns the doors of the room as a layout. */
+	FDoorLayout GetDoorLayout() const;
+
+	/** Replaces the doors of the room. */
+	void SetDoorLayout(const FDoorLayout& Layout);
+
+	/** Packs the item using variable-length integers. */
+	bool NetSerialize(FArchive& Archive, UPackageMap* PackageMap, bool& bOutSuccess);
+
+	//~ Begin FFastArraySerializerItem Interface
+	void PostReplicatedAdd(const FReplicatedDungeonRoomArray& InArraySerializer);
+	void PostReplicatedChange(const FReplicatedDungeonRoomArray& InArraySerializer);
+	void PreReplicatedRemove(const FReplicatedDungeonRoomArray& InArraySerializer);
+	//~ End FFastArraySerializerItem Interface
+};
+
+template<>
+struct TStructOpsTypeTraits<FReplicatedDungeonRoom> : public TStructOpsTypeTraitsBase2<FReplicatedDungeonRoom>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/** The replicated descriptions of every room of a dungeon. */
+USTRUCT()
+struct FReplicatedDungeonRoomArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FReplicatedDungeonRoom> Rooms;
+
+	/** The dungeon notified when a room is replicated; not replicated itself. */
+	ADungeon* Owner{ nullptr };
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParameters)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FReplicatedDungeonRoom, FReplicatedDungeonRoomArray>(Rooms, DeltaParameters, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FReplicatedDungeonRoomArray> : public TStructOpsTypeTraitsBase2<FReplicatedDungeonRoomArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -0,0 +1,237 @@
+/**
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Door storage for a room whose footprint is fixed at compile time. TRoomLayout<Width, Length> knows the number of
+ * segments of every wall as a constant, so validity checks fold into a comparison against a constant and whole-layout checks
+ * unroll into one mask test per wall. FRuntimeRoomLayout offers the same interface for footprints only known at runtime.
+ *
+ * Rooms of the common footprints are handled through VisitRoomLayout, which picks the fixed-size type matching a footprint
+ * and falls back to the runtime type for every other size. FDungeonLayout routes its wall and door slot checks through it,
+ * which covers the checks FDungeonLayoutGenerator makes for every placement it tries.
+ *
+ * Segment counts follow ADungeonRoom: a North or South wall has one segment per tile of width, and an East or West wall has one per tile of length.
+ */
+
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Dungeon/Rooms/DoorLayout.h"
+
+template <int32 Width, int32 Length>
+class TRoomLayout
+{
+	static_assert(Width > 0 && Length > 0, "A room must have at least one tile");
+	static_assert(Width <= FDoorLayout::MaxSegmentsPerWall && Length <= FDoorLayout::MaxSegmentsPerWall, "A wall has more segments than a door layout supports");
+
+public:
+	using FWallMask = FDoorLayout::FWallMask;
+
+	/** Returns the number of segments of the given wall. */
+	static constexpr int32 GetNumSegments(const EDirection Wall)
+	{
+		return Wall == EDirection::North || Wall == EDirection::South ? Width : Length;
+	}
+
+	/** Returns a mask with a bit set for every segment of the given wall. */
+	static constexpr FWallMask GetSegmentsMask(const EDirection Wall)
+	{
+		return GetNumSegments(Wall) == FDoorLayout::MaxSegmentsPerWall ? ~FWallMask{ 0 } : (FWallMask{ 1 } << GetNumSegments(Wall)) - 1;
+	}
+
+	/** Returns true if the segment exists on the given wall. */
+	static constexpr bool IsValidWallLocation(const EDirection Wall, const int32 SegmentIndex)
+	{
+		return SegmentIndex >= 0 && SegmentIndex < GetNumSegments(Wall);
+	}
+
+	/** Returns true if every door of the layout lies on a segment of the room's walls. */
+	static bool IsValidLayout(const FDoorLayout& Layout)
+	{
+		return (Layout.GetWallMask(EDirection::North) & ~GetSegmentsMask(EDirection::North)) == 0
+			&& (Layout.GetWallMask(EDirection::South) & ~GetSegmentsMask(EDirection::South)) == 0
+			&& (Layout.GetWallMask(EDirection::East)  & ~GetSegmentsMask(EDirection::East))	 == 0
+			&& (Layout.GetWallMask(EDirection::West)  & ~GetSegmentsMask(EDirection::West))	 == 0;
+	}
+
+	TRoomLayout() = default;
+
+	/**
+	 * Creates a layout holding the doors of the given layout.
+	 *
+	 * @warning An assertion is triggered if a door lies outside of the room's walls.
+	 */
+	explicit TRoomLayout(const FDoorLayout& Layout)
+		: m_Doors{ Layout }
+	{
+		checkf(IsValidLayout(Layout), TEXT("Error: Attempted to create a room layout with doors at invalid locations"));
+	}
+
+	/** Returns true if there is a door at the given segment; the segment must exist. */
+	bool HasDoor(const EDirection Wall, const int32 SegmentIndex) const
+	{
+		checkf(IsValidWallLocation(Wall, SegmentIndex), TEXT("Error: Attempted to check if there was a door at an invalid location"));
+		return m_Doors.HasDoor(Wall, SegmentIndex);
+	}
+
+	/** Adds a door at the given segment; the segment must exist. */
+	void AddDoor(const EDirection Wall, const int32 SegmentIndex)
+	{
+		checkf(IsValidWallLocation(Wall, SegmentIndex), TEXT("Error: Attempted to add a door to an invalid location"));
+		m_Doors.AddDoor(Wall, SegmentIndex);
+	}
+
+	/** Removes the door at the given segment; the segment must exist. */
+	void RemoveDoor(const EDirection Wall, const int32 SegmentIndex)
+	{
+		checkf(IsValidWallLocation(Wall, SegmentIndex), TEXT("Error: Attempted to remove a door from an invalid location"));
+		m_Doors.RemoveDoor(Wall, SegmentIndex);
+	}
+
+	/** Returns the mask of the segments of the given wall without a door. */
+	FWallMask GetFreeSegments(const EDirection Wall) const
+	{
+		return GetSegmentsMask(Wall) & ~m_Doors.GetWallMask(Wall);
+	}
+
+	/** Returns true if the segment exists, is one of the given door slots, and has no door yet. */
+	bool IsFreeDoorSlot(const FDoorLayout& DoorSlots, const EDirection Wall, const int32 SegmentIndex) const
+	{
+		return IsValidWallLocation(Wall, SegmentIndex) && (GetFreeSegments(Wall) & DoorSlots.GetWallMask(Wall) & (FWallMask{ 1 } << SegmentIndex)) != 0;
+	}
+
+	/** Returns the doors of the room. */
+	const FDoorLayout& GetDoors() const
+	{
+		return m_Doors;
+	}
+
+private:
+	FDoorLayout m_Doors;	// The doors of the room; never holds a door outside of its walls
+};
+
+/** The counterpart of TRoomLayout for footprints only known at runtime, such as unusually large rooms. */
+class FRuntimeRoomLayout
+{
+public:
+	using FWallMask = FDoorLayout::FWallMask;
+
+	/**
+	 * Creates a layout for a room of the given size holding the doors of the given layout.
+	 *
+	 * @warning An assertion is triggered if the room has no tiles, or if a door lies outside of the room's walls.
+	 */
+	FRuntimeRoomLayout(const int32 Width, const int32 Length, const FDoorLayout& Layout = FDoorLayout{ })
+		: m_Width{ Width }
+		, m_Length{ Length }
+		, m_Doors{ Layout }
+	{
+		checkf(Width > 0 && Length > 0, TEXT("Error: Attempted to create a room layout without any tiles"));
+		checkf(IsValidLayout(Layout), TEXT("Error: Attempted to create a room layout with doors at invalid locations"));
+	}
+
+	int32 GetNumSegments(const EDirection Wall) const
+	{
+		return Wall == EDirection::North || Wall == EDirection::South ? m_Width : m_Length;
+	}
+
+	FWallMask GetSegmentsMask(const EDirection Wall) const
+	{
+		return FDoorLayout::GetSegmentsMask(GetNumSegments(Wall));
+	}
+
+	bool IsValidWallLocation(const EDirection Wall, const int32 SegmentIndex) const
+	{
+		return SegmentIndex >= 0 && SegmentIndex < GetNumSegments(Wall);
+	}
+
+	bool IsValidLayout(const FDoorLayout& Layout) const
+	{
+		for (const EDirection Wall : FDoorLayout::WallDirections)
+		{
+			if ((Layout.GetWallMask(Wall) & ~GetSegmentsMask(Wall)) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool HasDoor(const EDirection Wall, const int32 SegmentIndex) const
+	{
+		checkf(IsValidWallLocation(Wall, SegmentIndex), TEXT("Error: Attempted to check if there was a door at an invalid location"));
+		return m_Doors.HasDoor(Wall, SegmentIndex);
+	}
+
+	void AddDoor(const EDirection Wall, const int32 SegmentIndex)
+	{
+		checkf(IsValidWallLocation(Wall, SegmentIndex), TEXT("Error: Attempted to add a door to an invalid location"));
+		m_Doors.AddDoor(Wall, SegmentIndex);
+	}
+
+	void RemoveDoor(const EDirection Wall, const int32 SegmentIndex)
+	{
+		checkf(IsValidWallLocation(Wall, SegmentIndex), TEXT("Error: Attempted to remove a door from an invalid location"));
+		m_Doors.RemoveDoor(Wall, SegmentIndex);
+	}
+
+	FWallMask GetFreeSegments(const EDirection Wall) const
+	{
+		return GetSegmentsMask(Wall) & ~m_Doors.GetWallMask(Wall);
+	}
+
+	bool IsFreeDoorSlot(const FDoorLayout& DoorSlots, const EDirection Wall, const int32 SegmentIndex) const
+	{
+		return IsValidWallLocation(Wall, SegmentIndex) && (GetFreeSegments(Wall) & DoorSlots.GetWallMask(Wall) & (FWallMask{ 1 } << SegmentIndex)) != 0;
+	}
+
+	const FDoorLayout& GetDoors() const
+	{
+		return m_Doors;
+	}
+
+private:
+	int32 	    m_Width;	// The number of segments of the North and South walls
+
+	int32 	    m_Length;	// The number of segments of the East and West walls
+
+	FDoorLayout m_Doors;	// The doors of the room; never holds a door outside of its walls
+};
+
+/** The largest width and length given a fixed-size layout by VisitRoomLayout. */
+constexpr int32 MaxFixedRoomLayoutSize{ 4 };
+
+namespace RoomLayoutDetail
+{
+	template <int32 Width, typename FunctorType>
+	decltype(auto) VisitWithLength(const int32 Length, const FDoorLayout& Layout, FunctorType&& Functor)
+	{
+		switch (Length)
+		{
+			case 1: return Functor(TRoomLayout<Width, 1>{ Layout });
+			case 2: return Functor(TRoomLayout<Width, 2>{ Layout });
+			case 3: return Functor(TRoomLayout<Width, 3>{ Layout });
+			case 4: return Functor(TRoomLayout<Width, 4>{ Layout });
+			default: return Functor(FRuntimeRoomLayout{ Width, Length, Layout });
+		}
+	}
+}
+
+/**
+ * Calls the functor with the layout of a room of the given size holding the given doors.
+ * Rooms of up to MaxFixedRoomLayoutSize tiles on each side receive their TRoomLayout; every other room receives an FRuntimeRoomLayout.
+ * The functor must accept either, typically through an auto parameter, and return the same type for both.
+ *
+ * @warning An assertion is triggered if a door lies outside of the room's walls.
+ */
+template <typename FunctorType>
+decltype(auto) VisitRoomLayout(const int32 Width, const int32 Length, const FDoorLayout& Layout, FunctorType&& Functor)
+{
+	switch (Width)
+	{
+		case 1: return RoomLayoutDetail::VisitWithLength<1>(Length, Layout, Forward<FunctorType>(Functor));
+		case 2: return RoomLayoutDetail::VisitWithLength<2>(Length, Layout, Forward<FunctorType>(Functor));
+		case 3: return RoomLayoutDetail::VisitWithLength<3>(Length, Layout, Forward<FunctorType>(Functor));
+		case 4: return RoomLayoutDetail::VisitWithLength<4>(Length, Layout, Forward<FunctorType>(Functor));
+		default: return Functor(FRuntimeRoomLayout{ Width, Length, Layout });
+	}
+}
@@ -7,6 +7,8 @@
  * @warning Each segment must be identified with a numerical index tag, which represents its position within the wall. Counting begins at 0.
  * 
  * @note The decision to use tags for identifying specific wall segments, rather than determining them at runtime, was made for performance and simplicity.
+ * @note The tags are parsed when the owning blueprint is saved and baked into a serialized index table, so runtime initialization is a pointer-array copy.
+ *       Walls saved before the table existed fall back to parsing the tags at runtime until their blueprint is resaved.
  */
 
 #pragma once
@@ -39,10 +41,20 @@ public:
 	 */
 	UWallSegment* GetSegment(int32 SegmentIndex);
 
+	/** Returns the number of segments that make up the wall. */
+	int32 GetNumSegments() const;
+
 private:
 	/** Contains the segment meshes sorted by index. */
 	TArray<UStaticMeshComponent*> m_SegmentMeshes { }; 
 
+	/**
+	 * Holds the segment index of each attached child, in attach order.
+	 * Baked from the segments' index tags when the owning blueprint is saved; editor builds check it against the tags at spawn.
+	 */
+	UPROPERTY(VisibleDefaultsOnly)
+	TArray<int32> m_SegmentIndexByChild { };
+
 	/**
          * Ensures that the internal array m_SegmentMeshes is properly initialized.
 	 * 
@@ -53,9 +65,32 @@ private:
 	/** Initializes the array m_SegmentMeshes by populating it with the child components of this instance. */
 	void InitializeSegmentMeshes();
 
+	/** Builds the segment index table from the wall's attached children. */
+	bool BuildSegmentIndexTable(TArray<int32>& OutSegmentIndexByChild) const;
+
+	/**
+	 * Builds the table holding the segment index of each of the given segments by parsing their index tags.
+	 *
+	 * @return True if every segment is a static mesh with a unique index tag in the range [0, number of segments); errors are logged otherwise.
+	 */
+	bool BuildSegmentIndexTable(TConstArrayView<const USceneComponent*> Segments, TArray<int32>& OutSegmentIndexByChild) const;
+
 	/** 
-	 * Returns the index of the specified segment.
-	 * This function is called during initialization.
+	 * Parses the index tag of the specified segment.
+	 * 
+	 * @return True if the segment has a numerical index tag.
+	 */
+	bool TryGetIndexOfSegment(const USceneComponent* Segment, int32& OutSegmentIndex) const;
+
+#if WITH_EDITOR
+	/** Bakes the segment index table whenever the wall's package is saved, which covers blueprint templates as well as placed walls. */
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+
+	/**
+	 * Gathers the segment templates a blueprint attaches to this wall, in the order it spawns them.
+	 *
+	 * @return False if this wall is not a component of a blueprint generated class.
 	 */
-	int32 GetIndexOfSegment(USceneComponent* Segment);
+	bool GetBlueprintSegmentTemplates(TArray<const USceneComponent*>& OutSegments) const;
+#endif
 };
@@ -0,0 +1,79 @@
+#include "AliasTable.h"
+
+FAliasTable::FAliasTable(TConstArrayView<float> Weights)
+{
+	const int32 NumWeights{ Weights.Num() };
+
+	m_Probabilities.SetNumUninitialized(NumWeights);
+	m_Aliases.SetNumUninitialized(NumWeights);
+
+	double TotalWeight{ 0.0 };
+	for (const float Weight : Weights)
+	{
+		TotalWeight += FMath::Max(Weight, 0.0f);
+	}
+
+	// scale the weights so that the average is 1, then pair every under-full index with an over-full one
+	TArray<double> ScaledWeights;
+	ScaledWeights.SetNumUninitialized(NumWeights);
+	for (int32 Index{ 0 }; Index < NumWeights; ++Index)
+	{
+		ScaledWeights[Index] = TotalWeight > 0.0 ? FMath::Max(Weights[Index], 0.0f) * NumWeights / TotalWeight : 1.0;
+	}
+
+	TArray<int32> Small;
+	TArray<int32> Large;
+	Small.Reserve(NumWeights);
+	Large.Reserve(NumWeights);
+	for (int32 Index{ 0 }; Index < NumWeights; ++Index)
+	{
+		(ScaledWeights[Index] < 1.0 ? Small : Large).Add(Index);
+	}
+
+	while (Small.Num() > 0 && Large.Num() > 0)
+	{
+		const int32 SmallIndex{ Small.Pop(EAllowShrinking::No) };
+		const int32 LargeIndex{ Large.Last() };
+
+		m_Probabilities[SmallIndex] = static_cast<float>(ScaledWeights[SmallIndex]);
+		m_Aliases[SmallIndex] = LargeIndex;
+
+		ScaledWeights[LargeIndex] -= 1.0 - ScaledWeights[SmallIndex];
+		if (ScaledWeights[LargeIndex] < 1.0)
+		{
+			Large.Pop(EAllowShrinking::No);
+			Small.Add(LargeIndex);
+		}
+	}
+
+	// whatever remains is full up to rounding error
+	for (const int32 Index : Large)
+	{
+		m_Probabilities[Index] = 1.0f;
+		m_Aliases[Index] = Index;
+	}
+	for (const int32 Index : Small)
+	{
+		m_Probabilities[Index] = 1.0f;
+		m_Aliases[Index] = Index;
+	}
+}
+
+int32 FAliasTable::Sample(const FRandomStream& RandomStream) const
+{
+	checkf(Num() > 0, TEXT("Error: Attempted to sample an empty alias table"));
+
+	const int32 Index{ RandomStream.RandHelper(Num()) };
+
+	return RandomStream.GetFraction() < m_Probabilities[Index] ? Index : m_Aliases[Index];
+}
+
+int32 FAliasTable::Num() const
+{
+	return m_Probabilities.Num();
+}
+
+SIZE_T FAliasTable::GetAllocatedSize() const
+{
+	return m_Probabilities.GetAllocatedSize() + m_Aliases.GetAllocatedSize();
+}
@@ -3,23 +3,1157 @@
 
 #include "Dungeon.h"
 
+#include "Dungeon/DungeonStats.h"
+#include "Dungeon/Rooms/DungeonRoomPool.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Net/UnrealNetwork.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/FileHelper.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "PrimitiveSceneProxy.h"
+#include "RenderingThread.h"
+
+namespace
+{
+	/** Identifies the start of a dungeon snapshot; "DGNS" when read as bytes. */
+	constexpr uint32 DungeonSnapshotMagic{ 0x534E4744 };
+
+	/** Incremented whenever the layout of a snapshot changes; snapshots of other versions are rejected rather than misread. */
+	constexpr uint32 DungeonSnapshotVersion{ 3 };
+
+	/** Logs the memory report of every dungeon in the world; pass "rooms" to include a line for every room. */
+	FAutoConsoleCommandWithWorldAndArgs MemoryReportCommand{
+		TEXT("Dungeon.MemoryReport"),
+		TEXT("Logs the memory held by every dungeon's rooms, components, render proxies, referenced meshes and room database. Usage: Dungeon.MemoryReport [rooms]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (!World)
+			{
+				return;
+			}
+
+			// proxy sizes are read from the game thread, so every pending render command must have run first
+			FlushRenderingCommands();
+
+			const bool bIncludeRooms{ Args.ContainsByPredicate([](const FString& Arg) { return Arg.Equals(TEXT("rooms"), ESearchCase::IgnoreCase); }) };
+			for (TActorIterator<ADungeon> Iterator{ World }; Iterator; ++Iterator)
+			{
+				Iterator->LogMemoryReport(bIncludeRooms);
+			}
+		})
+	};
+}
+
 ADungeon::ADungeon()
 	: m_RootComponent{ CreateDefaultSubobject<USceneComponent>(TEXT("Root")) }
+	, m_SegmentRenderer{ CreateDefaultSubobject<UInstancedSegmentRenderer>(TEXT("SegmentRenderer")) }
 {
-	PrimaryActorTick.bCanEverTick = false;
+	// only ticks to stream rooms, which is enabled in BeginPlay
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	RootComponent = m_RootComponent;
+	m_SegmentRenderer->SetupAttachment(m_RootComponent);
+
+	// rooms are described by m_ReplicatedRooms and spawned locally on clients, so only the dungeon itself replicates
+	bReplicates = true;
+	m_ReplicatedRooms.Owner = this;
 }
 
 void ADungeon::AddRoom(ADungeonRoom* Room)
 {
-	m_RoomsArray.Add(Room);
+	DUNGEON_SCOPE_CYCLE_COUNTER(STAT_DungeonAddRoom);
+
+	const int32 RoomIndex{ m_RoomsArray.Add(nullptr) };
+	const FTileFootprint Footprint{ GetFootprint(Room) };
+	m_RoomGrid.AddRoom(RoomIndex, Footprint);
+	m_RoomGraph.AddRoom(RoomIndex);
+	m_RoomTable.AddRoom(RoomIndex, Footprint, Room->GetDoorLayout());
+
+	// the initial seed is kept rather than the stream itself, so a room streamed back in picks the meshes a freshly spawned one would
+	FRoomRecord& Record{ m_RoomRecords.AddDefaulted_GetRef() };
+	Record.ClassPath    = FSoftObjectPath{ Room->GetClass() };
+	Record.RandomStream = FRandomStream{ Room->GetRandomStream().GetInitialSeed() };
+
+	InstallRoom(Room, RoomIndex);
+
+	// the room's doors may already face doors of its neighbors, such as those placed when it was spawned
+	const FDoorLayout& Layout{ Room->GetDoorLayout() };
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		FDoorLayout::FWallMask Doors{ Layout.GetWallMask(Direction) };
+		while (Doors != 0)
+		{
+			UpdateDoorConnection(RoomIndex, Direction, static_cast<int32>(FMath::CountTrailingZeros64(Doors)), true);
+			Doors &= Doors - 1;
+		}
+	}
+}
+
+void ADungeon::InstallRoom(ADungeonRoom* Room, int32 RoomIndex)
+{
+	m_RoomsArray[RoomIndex] = Room;
+	m_RoomIndices.Add(Room, RoomIndex);
+
+	Room->OnDoorChanged().AddUObject(this, &ADungeon::HandleDoorChanged);
+
 	Room->AttachToComponent(m_RootComponent, FAttachmentTransformRules::KeepWorldTransform);
+
+	if (m_bUseInstancedSegments)
+	{
+		Room->EnableInstancedRendering(m_SegmentRenderer);
+	}
+	else if (m_bFinalizeRooms)
+	{
+		Room->FinalizeSegments();
+	}
+}
+
+TArray<ADungeonRoom*> ADungeon::SpawnLayout(const FDungeonLayout& Layout, int32 Seed)
+{
+	DUNGEON_SCOPE_CYCLE_COUNTER(STAT_DungeonSpawnLayout);
+
+	// a snapshot still loading would otherwise spawn its rooms on top of the layout's
+	CancelSnapshotRestore();
+
+	if (HasAuthority())
+	{
+		m_Seed = Seed;
+	}
+
+	TArray<ADungeonRoom::FSpawnInfo> SpawnInfos;
+	TArray<int32> LayoutIndices;		// the layout index of every spawn info
+	SpawnInfos.Reserve(Layout.Num());
+	LayoutIndices.Reserve(Layout.Num());
+
+	for (int32 LayoutIndex{ 0 }; LayoutIndex < Layout.Num(); ++LayoutIndex)
+	{
+		const FDungeonLayoutRoom& LayoutRoom{ Layout.GetRooms()[LayoutIndex] };
+
+		UObject* LoadedAsset{ LayoutRoom.AssetPath.TryLoad() };
+		if (!LoadedAsset)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Error: Failed to load room asset: %s"), *LayoutRoom.AssetPath.ToString());
+			continue;
+		}
+
+		ADungeonRoom::FSpawnInfo& SpawnInfo{ SpawnInfos.AddDefaulted_GetRef() };
+		SpawnInfo.LoadedAsset  = LoadedAsset;
+		SpawnInfo.RoomLocation = TileToWorld(LayoutRoom.Footprint.Origin);
+		SpawnInfo.RandomStream = GetRoomRandomStream(Seed, LayoutIndex);
+
+		for (const EDirection Direction : FDoorLayout::WallDirections)
+		{
+			FDoorLayout::FWallMask Doors{ LayoutRoom.Doors.GetWallMask(Direction) };
+			while (Doors != 0)
+			{
+				SpawnInfo.DoorLocations.Add({ Direction, static_cast<int32>(FMath::CountTrailingZeros64(Doors)) });
+				Doors &= Doors - 1;
+			}
+		}
+
+		LayoutIndices.Add(LayoutIndex);
+	}
+
+	// the whole floor is spawned as one batch, so its segment changes are planned on worker threads and applied in one pass
+	TArray<ADungeonRoom*> BatchedRooms;
+	ADungeonRoom::SpawnBatch(SpawnInfos, GetWorld(), BatchedRooms);
+
+	TArray<ADungeonRoom*> SpawnedRooms;
+	SpawnedRooms.Init(nullptr, Layout.Num());
+
+	for (int32 SpawnIndex{ 0 }; SpawnIndex < BatchedRooms.Num(); ++SpawnIndex)
+	{
+		const int32 LayoutIndex{ LayoutIndices[SpawnIndex] };
+		const FDungeonLayoutRoom& LayoutRoom{ Layout.GetRooms()[LayoutIndex] };
+
+		ADungeonRoom* SpawnedRoom{ BatchedRooms[SpawnIndex] };
+		AddRoom(SpawnedRoom);
+		SpawnedRooms[LayoutIndex] = SpawnedRoom;
+
+		const int32 RoomIndex{ m_RoomIndices.FindChecked(SpawnedRoom) };
+		m_RoomRecords[RoomIndex].AssetPath = LayoutRoom.AssetPath;
+
+		if (m_Prefetcher)
+		{
+			m_Prefetcher->MarkUsed(LayoutRoom.AssetPath);
+		}
+
+		if (HasAuthority())
+		{
+			AddReplicatedRoom(RoomIndex, LayoutRoom.AssetPath, LayoutRoom.Footprint.Origin, LayoutIndex);
+		}
+	}
+
+	return SpawnedRooms;
+}
+
+bool ADungeon::SaveSnapshot(TArray<uint8>& OutBytes) const
+{
+	OutBytes.Reset();
+
+	if (!m_RoomDatabase)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Attempted to save a snapshot of a dungeon without a room database"));
+		return false;
+	}
+
+	// rooms refer to their asset through a table of the snapshot's own paths, so adding or renaming other assets keeps the snapshot readable
+	TArray<FSoftObjectPath> AssetPaths;
+	TArray<int32> PathIndices;		// the index in AssetPaths of every room's asset
+	PathIndices.Reserve(m_RoomRecords.Num());
+	for (const FRoomRecord& Record : m_RoomRecords)
+	{
+		if (!m_RoomDatabase->FindDoorSlots(Record.AssetPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Error: Failed to save a snapshot, since a room's asset is not in the dungeon's room database: %s"),
+				*Record.AssetPath.ToString());
+			return false;
+		}
+		PathIndices.Add(AssetPaths.AddUnique(Record.AssetPath));
+	}
+
+	FMemoryWriter Writer{ OutBytes };
+
+	uint32 Magic{ DungeonSnapshotMagic };
+	uint32 Version{ DungeonSnapshotVersion };
+	int32 Seed{ m_Seed };
+	int32 NumPaths{ AssetPaths.Num() };
+	Writer << Magic << Version << Seed << NumPaths;
+
+	for (const FSoftObjectPath& AssetPath : AssetPaths)
+	{
+		FString PathString{ AssetPath.ToString() };
+		Writer << PathString;
+	}
+
+	int32 NumRooms{ m_RoomRecords.Num() };
+	Writer << NumRooms;
+
+	// read from the room table rather than the actors, so rooms that are streamed out are saved too
+	for (int32 RoomIndex{ 0 }; RoomIndex < NumRooms; ++RoomIndex)
+	{
+		int32 PathIndex{ PathIndices[RoomIndex] };
+
+		// the room's own seed rather than its index, which drifts from the layout index whenever a room was skipped or added separately
+		int32 RandomSeed{ m_RoomRecords[RoomIndex].RandomStream.GetInitialSeed() };
+
+		const FIntPoint Origin{ m_RoomTable.GetFootprint(RoomIndex).Origin };
+		int32 OriginX{ Origin.X };
+		int32 OriginY{ Origin.Y };
+
+		// most walls have no doors, so only the masks of walls with doors are written
+		const FDoorLayout Doors{ m_RoomTable.GetDoorLayout(RoomIndex) };
+		uint8 WallsWithDoors{ 0 };
+		for (int32 WallIndex{ 0 }; WallIndex < FDoorLayout::NumWalls; ++WallIndex)
+		{
+			if (Doors.GetWallMask(FDoorLayout::WallDirections[WallIndex]) != 0)
+			{
+				WallsWithDoors |= 1 << WallIndex;
+			}
+		}
+
+		Writer << PathIndex << RandomSeed << OriginX << OriginY << WallsWithDoors;
+		for (int32 WallIndex{ 0 }; WallIndex < FDoorLayout::NumWalls; ++WallIndex)
+		{
+			if (WallsWithDoors & (1 << WallIndex))
+			{
+				FDoorLayout::FWallMask Mask{ Doors.GetWallMask(FDoorLayout::WallDirections[WallIndex]) };
+				Writer << Mask;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool ADungeon::SaveSnapshotToFile(const FString& FilePath) const
+{
+	TArray<uint8> Bytes;
+	if (!SaveSnapshot(Bytes))
+	{
+		return false;
+	}
+
+	if (!FFileHelper::SaveArrayToFile(Bytes, *FilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Failed to write dungeon snapshot: %s"), *FilePath);
+		return false;
+	}
+	return true;
+}
+
+bool ADungeon::RestoreSnapshot(TConstArrayView<uint8> Bytes, FOnSnapshotRestored OnRestored)
+{
+	if (!m_RoomDatabase)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Attempted to restore a snapshot into a dungeon without a room database"));
+		return false;
+	}
+
+	FMemoryReaderView Reader{ Bytes };
+
+	uint32 Magic{ 0 };
+	uint32 Version{ 0 };
+	Reader << Magic << Version;
+
+	if (Reader.IsError() || Magic != DungeonSnapshotMagic)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Attempted to restore data that is not a dungeon snapshot"));
+		return false;
+	}
+	if (Version != DungeonSnapshotVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Attempted to restore a dungeon snapshot of version %u, expected version %u"), Version, DungeonSnapshotVersion);
+		return false;
+	}
+
+	int32 Seed{ 0 };
+	int32 NumPaths{ 0 };
+	Reader << Seed << NumPaths;
+
+	// counts are checked against the bytes left before reserving, so a corrupt count cannot request a huge allocation
+	constexpr int64 MinPathBytes{ sizeof(int32) };
+	if (Reader.IsError() || NumPaths < 0 || NumPaths > (Reader.TotalSize() - Reader.Tell()) / MinPathBytes)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Attempted to restore a dungeon snapshot with an invalid number of assets"));
+		return false;
+	}
+
+	// paths are looked up rather than indices, so the snapshot only depends on the assets it uses still being in the database
+	TArray<FSoftObjectPath> PathTable;
+	PathTable.Reserve(NumPaths);
+	for (int32 PathIndex{ 0 }; PathIndex < NumPaths; ++PathIndex)
+	{
+		FString PathString;
+		Reader << PathString;
+
+		const FSoftObjectPath& AssetPath{ PathTable.Emplace_GetRef(PathString) };
+		if (Reader.IsError() || !m_RoomDatabase->FindDoorSlots(AssetPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Error: Attempted to restore a dungeon snapshot with an asset that is not in the room database: %s"), *PathString);
+			return false;
+		}
+	}
+
+	int32 NumRooms{ 0 };
+	Reader << NumRooms;
+
+	constexpr int64 MinRoomBytes{ sizeof(int32) * 4 + sizeof(uint8) };
+	if (Reader.IsError() || NumRooms < 0 || NumRooms > (Reader.TotalSize() - Reader.Tell()) / MinRoomBytes)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Attempted to restore a dungeon snapshot with an invalid number of rooms"));
+		return false;
+	}
+
+	TArray<FSnapshotRoom> SnapshotRooms;
+	SnapshotRooms.Reserve(NumRooms);
+	TArray<FSoftObjectPath> AssetPaths;
+	FDungeonTileGrid SnapshotGrid;		// the tiles covered by the rooms read so far
+
+	for (int32 SnapshotIndex{ 0 }; SnapshotIndex < NumRooms; ++SnapshotIndex)
+	{
+		int32 PathIndex{ INDEX_NONE };
+		FSnapshotRoom& SnapshotRoom{ SnapshotRooms.AddDefaulted_GetRef() };
+		uint8 WallsWithDoors{ 0 };
+		Reader << PathIndex << SnapshotRoom.RandomSeed << SnapshotRoom.Origin.X << SnapshotRoom.Origin.Y << WallsWithDoors;
+
+		for (int32 WallIndex{ 0 }; WallIndex < FDoorLayout::NumWalls; ++WallIndex)
+		{
+			if (WallsWithDoors & (1 << WallIndex))
+			{
+				FDoorLayout::FWallMask Mask{ 0 };
+				Reader << Mask;
+				SnapshotRoom.Doors.SetWallMask(FDoorLayout::WallDirections[WallIndex], Mask);
+			}
+		}
+
+		const FSoftObjectPath* AssetPath{ PathTable.IsValidIndex(PathIndex) ? &PathTable[PathIndex] : nullptr };
+		const FDoorLayout* DoorSlots{ AssetPath ? m_RoomDatabase->FindDoorSlots(*AssetPath) : nullptr };
+
+		// rejected here rather than when the rooms are spawned, where a door outside of a room's slots triggers an assertion
+		if (Reader.IsError() || !DoorSlots || !DoorSlots->Contains(SnapshotRoom.Doors))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Error: Attempted to restore a dungeon snapshot with an invalid room at index %d"), SnapshotIndex);
+			return false;
+		}
+
+		// likewise, rooms out of replication range or overlapping another room would trigger an assertion once added
+		const FIntPoint& Origin{ SnapshotRoom.Origin };
+		const FDungeonRoomSpecs& Specs{ *m_RoomDatabase->FindRoomSpecs(*AssetPath) };
+		const FTileFootprint Footprint{ Origin, Specs.Dimensions.Width, Specs.Dimensions.Length };
+		if (Origin.X < MIN_int16 || Origin.X > MAX_int16 || Origin.Y < MIN_int16 || Origin.Y > MAX_int16 || !SnapshotGrid.IsAreaFree(Footprint))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Error: Attempted to restore a dungeon snapshot with a misplaced room at index %d"), SnapshotIndex);
+			return false;
+		}
+		SnapshotGrid.AddRoom(SnapshotIndex, Footprint);
+
+		SnapshotRoom.AssetPath = *AssetPath;
+		AssetPaths.AddUnique(*AssetPath);
+	}
+
+	if (Reader.Tell() != Reader.TotalSize())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Attempted to restore a dungeon snapshot with trailing data"));
+		return false;
+	}
+
+	// only a valid snapshot replaces the current rooms, including those of a restore still loading
+	CancelSnapshotRestore();
+
+	ReleaseRooms();
+	if (HasAuthority())
+	{
+		m_Seed = Seed;
+	}
+
+	if (AssetPaths.Num() == 0)
+	{
+		SpawnSnapshotRooms(SnapshotRooms, OnRestored);
+		return true;
+	}
+
+	// the handle starts stalled, so it is stored before the delegate can run, even when every asset is already loaded
+	m_SnapshotLoadHandle = m_SnapshotStreamer.RequestAsyncLoad(MoveTemp(AssetPaths), FStreamableDelegate::CreateWeakLambda(this,
+		[this, SnapshotRooms{ MoveTemp(SnapshotRooms) }, OnRestored{ MoveTemp(OnRestored) }]()
+	{
+		// taken out of the member before spawning, so that a restore started by OnRestored keeps its own handle
+		const TSharedPtr<FStreamableHandle> LoadHandle{ MoveTemp(m_SnapshotLoadHandle) };
+		SpawnSnapshotRooms(SnapshotRooms, OnRestored);
+	}), FStreamableManager::DefaultAsyncLoadPriority, false, true);
+
+	if (m_SnapshotLoadHandle.IsValid())
+	{
+		m_SnapshotLoadHandle->StartStalledHandle();
+	}
+
+	return true;
+}
+
+bool ADungeon::IsRestoringSnapshot() const
+{
+	return m_SnapshotLoadHandle.IsValid();
+}
+
+void ADungeon::CancelSnapshotRestore()
+{
+	if (m_SnapshotLoadHandle.IsValid())
+	{
+		m_SnapshotLoadHandle->CancelHandle();
+		m_SnapshotLoadHandle.Reset();
+	}
+}
+
+bool ADungeon::RestoreSnapshotFromFile(const FString& FilePath, FOnSnapshotRestored OnRestored)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Failed to read dungeon snapshot: %s"), *FilePath);
+		return false;
+	}
+
+	return RestoreSnapshot(Bytes, MoveTemp(OnRestored));
+}
+
+void ADungeon::SpawnSnapshotRooms(TConstArrayView<FSnapshotRoom> SnapshotRooms, const FOnSnapshotRestored& OnRestored)
+{
+	TArray<ADungeonRoom::FSpawnInfo> SpawnInfos;
+	TArray<int32> SnapshotIndices;		// the snapshot index of every spawn info
+	SpawnInfos.Reserve(SnapshotRooms.Num());
+	SnapshotIndices.Reserve(SnapshotRooms.Num());
+
+	for (int32 SnapshotIndex{ 0 }; SnapshotIndex < SnapshotRooms.Num(); ++SnapshotIndex)
+	{
+		const FSnapshotRoom& SnapshotRoom{ SnapshotRooms[SnapshotIndex] };
+
+		UObject* LoadedAsset{ SnapshotRoom.AssetPath.TryLoad() };
+		if (!LoadedAsset)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Error: Failed to load room asset: %s"), *SnapshotRoom.AssetPath.ToString());
+			continue;
+		}
+
+		ADungeonRoom::FSpawnInfo& SpawnInfo{ SpawnInfos.AddDefaulted_GetRef() };
+		SpawnInfo.LoadedAsset  = LoadedAsset;
+		SpawnInfo.RoomLocation = TileToWorld(SnapshotRoom.Origin);
+		SpawnInfo.RandomStream = FRandomStream{ SnapshotRoom.RandomSeed };
+		SpawnInfo.DoorLayout   = SnapshotRoom.Doors;
+
+		SnapshotIndices.Add(SnapshotIndex);
+	}
+
+	TArray<ADungeonRoom*> BatchedRooms;
+	ADungeonRoom::SpawnBatch(SpawnInfos, GetWorld(), BatchedRooms);
+
+	TArray<ADungeonRoom*> RestoredRooms;
+	RestoredRooms.Init(nullptr, SnapshotRooms.Num());
+
+	for (int32 SpawnIndex{ 0 }; SpawnIndex < BatchedRooms.Num(); ++SpawnIndex)
+	{
+		const int32 SnapshotIndex{ SnapshotIndices[SpawnIndex] };
+		const FSnapshotRoom& SnapshotRoom{ SnapshotRooms[SnapshotIndex] };
+
+		ADungeonRoom* SpawnedRoom{ BatchedRooms[SpawnIndex] };
+		AddRoom(SpawnedRoom);
+		RestoredRooms[SnapshotIndex] = SpawnedRoom;
+
+		const int32 RoomIndex{ m_RoomIndices.FindChecked(SpawnedRoom) };
+		m_RoomRecords[RoomIndex].AssetPath = SnapshotRoom.AssetPath;
+
+		if (HasAuthority())
+		{
+			AddReplicatedRoom(RoomIndex, SnapshotRoom.AssetPath, SnapshotRoom.Origin, SnapshotIndex);
+		}
+	}
+
+	if (OnRestored)
+	{
+		OnRestored(RestoredRooms);
+	}
+}
+
+void ADungeon::ReleaseRooms()
+{
+	if (m_StreamingSpawner)
+	{
+		m_StreamingSpawner->CancelAll();
+	}
+
+	UDungeonRoomPool* Pool{ GetWorld()->GetSubsystem<UDungeonRoomPool>() };
+
+	for (ADungeonRoom* Room : m_RoomsArray)
+	{
+		if (!IsValid(Room))
+		{
+			continue;
+		}
+
+		Room->OnDoorChanged().RemoveAll(this);
+
+		if (Pool)
+		{
+			Pool->Release(Room);
+		}
+		else
+		{
+			Room->Destroy();
+		}
+	}
+
+	m_RoomsArray.Reset();
+	m_RoomIndices.Reset();
+	m_RoomRecords.Reset();
+	m_RoomTable.Reset();
+	m_RoomGrid.Reset();
+	m_RoomGraph.Reset();
+
+	m_ReplicationIDsByRoomIndex.Reset();
+	m_RoomIndicesByReplicationID.Reset();
+	m_ItemIndicesByReplicationID.Reset();
+	if (HasAuthority())
+	{
+		m_ReplicatedRooms.Rooms.Reset();
+		m_ReplicatedRooms.MarkArrayDirty();
+	}
+}
+
+void ADungeon::SetRoomDatabase(TSharedPtr<const FDungeonRoomDatabase> RoomDatabase)
+{
+	m_RoomDatabase = MoveTemp(RoomDatabase);
+
+	// items that arrived before the database could not be resolved yet
+	if (!HasAuthority())
+	{
+		ApplyReplicatedRooms();
+	}
+}
+
+void ADungeon::PrefetchNextFloor(EDungeonTheme Theme, const FDungeonLayout* NextLayout)
+{
+	checkf(m_RoomDatabase.IsValid(), TEXT("Error: Attempted to prefetch the next floor without a room database"));
+
+	if (!m_Prefetcher)
+	{
+		m_Prefetcher = MakeUnique<FDungeonRoomPrefetcher>(m_RoomDatabase, static_cast<int64>(m_PrefetchBudgetMegabytes) * 1024 * 1024);
+	}
+
+	m_Prefetcher->PrefetchFloor(Theme, NextLayout);
+}
+
+int32 ADungeon::GetNumRooms() const
+{
+	return m_RoomsArray.Num();
+}
+
+ADungeonRoom* ADungeon::GetRoom(int32 RoomIndex) const
+{
+	return m_RoomsArray[RoomIndex];
+}
+
+FDoorLayout ADungeon::GetRoomDoorLayout(int32 RoomIndex) const
+{
+	return m_RoomTable.GetDoorLayout(RoomIndex);
+}
+
+const FDungeonRoomTable& ADungeon::GetRoomTable() const
+{
+	return m_RoomTable;
+}
+
+void ADungeon::SetRoomDoorLayout(int32 RoomIndex, const FDoorLayout& Layout)
+{
+	if (ADungeonRoom* Room{ m_RoomsArray[RoomIndex] })
+	{
+		// the room broadcasts every changed door, which updates the graph
+		Room->ApplyDoorLayout(Layout);
+		return;
+	}
+
+	const FDoorLayout PreviousDoors{ m_RoomTable.GetDoorLayout(RoomIndex) };
+	m_RoomTable.SetDoorLayout(RoomIndex, Layout);
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		FDoorLayout::FWallMask ChangedDoors{ PreviousDoors.GetWallMask(Direction) ^ Layout.GetWallMask(Direction) };
+		while (ChangedDoors != 0)
+		{
+			const int32 SegmentIndex{ static_cast<int32>(FMath::CountTrailingZeros64(ChangedDoors)) };
+			UpdateDoorConnection(RoomIndex, Direction, SegmentIndex, Layout.HasDoor(Direction, SegmentIndex));
+			ChangedDoors &= ChangedDoors - 1;
+		}
+	}
+}
+
+void ADungeon::UpdateStreaming(TConstArrayView<FVector> ViewerLocations)
+{
+	TArray<int32> ViewerRoomIndices;
+	for (const FVector& ViewerLocation : ViewerLocations)
+	{
+		const int32 RoomIndex{ m_RoomGrid.FindRoomAt(WorldToTile(ViewerLocation)) };
+		if (RoomIndex != INDEX_NONE)
+		{
+			ViewerRoomIndices.AddUnique(RoomIndex);
+		}
+	}
+
+	if (ViewerRoomIndices.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<int32> Distances;
+	m_RoomGraph.GetDistances(ViewerRoomIndices, Distances);
+
+	TArray<int32> RoomsToStreamIn;
+	for (int32 RoomIndex{ 0 }; RoomIndex < m_RoomsArray.Num(); ++RoomIndex)
+	{
+		const bool bIsWithinHops{ Distances[RoomIndex] != INDEX_NONE && Distances[RoomIndex] <= m_StreamingHops };
+		const bool bShouldBeStreamedIn{ bIsWithinHops || IsRoomNearViewer(RoomIndex, ViewerLocations) };
+
+		const bool bIsStreamedIn{ m_RoomsArray[RoomIndex] != nullptr };
+		if (bIsStreamedIn && !bShouldBeStreamedIn)
+		{
+			StreamOutRoom(RoomIndex);
+		}
+		else if (!bIsStreamedIn && bShouldBeStreamedIn && !m_RoomRecords[RoomIndex].bIsStreamingIn)
+		{
+			RoomsToStreamIn.Add(RoomIndex);
+		}
+	}
+
+	if (RoomsToStreamIn.Num() > 0)
+	{
+		StreamInRooms(RoomsToStreamIn);
+	}
+}
+
+bool ADungeon::IsRoomNearViewer(int32 RoomIndex, TConstArrayView<FVector> ViewerLocations) const
+{
+	if (m_StreamingDistance <= 0.0f)
+	{
+		return false;
+	}
+
+	const FTileFootprint Footprint{ m_RoomTable.GetFootprint(RoomIndex) };
+	const FVector Min{ TileToWorld(Footprint.Origin) };
+	const FVector Max{ TileToWorld(Footprint.GetEnd()) };
+	const FBox2D Bounds{ FVector2D{ Min }, FVector2D{ Max } };
+
+	const float StreamingDistanceSquared{ m_StreamingDistance * m_StreamingDistance };
+	for (const FVector& ViewerLocation : ViewerLocations)
+	{
+		if (Bounds.ComputeSquaredDistanceToPoint(FVector2D{ ViewerLocation }) <= StreamingDistanceSquared)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void ADungeon::StreamOutRoom(int32 RoomIndex)
+{
+	ADungeonRoom* Room{ m_RoomsArray[RoomIndex] };
+
+	// the room table already holds the room's doors, so nothing but the actor needs to go
+	Room->OnDoorChanged().RemoveAll(this);
+	m_RoomIndices.Remove(Room);
+	m_RoomsArray[RoomIndex] = nullptr;
+
+	// destroyed rather than pooled, so that its components and meshes are actually released
+	Room->Destroy();
+}
+
+void ADungeon::StreamInRooms(TConstArrayView<int32> RoomIndices)
+{
+	if (!m_StreamingSpawner)
+	{
+		m_StreamingSpawner = MakeUnique<FDungeonRoomAsyncSpawner>(GetWorld());
+	}
+
+	TArray<FDungeonRoomAsyncSpawner::FAsyncSpawnInfo> SpawnInfos;
+	SpawnInfos.Reserve(RoomIndices.Num());
+
+	for (const int32 RoomIndex : RoomIndices)
+	{
+		FRoomRecord& Record{ m_RoomRecords[RoomIndex] };
+		Record.bIsStreamingIn = true;
+
+		FDungeonRoomAsyncSpawner::FAsyncSpawnInfo& SpawnInfo{ SpawnInfos.AddDefaulted_GetRef() };
+		SpawnInfo.AssetPath    = Record.ClassPath;
+		SpawnInfo.RoomLocation = TileToWorld(m_RoomTable.GetFootprint(RoomIndex).Origin);
+		SpawnInfo.RandomStream = Record.RandomStream;
+		SpawnInfo.OnSpawned    = [WeakThis = TWeakObjectPtr<ADungeon>{ this }, RoomIndex](ADungeonRoom* SpawnedRoom)
+		{
+			ADungeon* This{ WeakThis.Get() };
+			if (!This)
+			{
+				return;
+			}
+
+			// cleared even when the asset failed to load, so that the room is requested again on a later update
+			This->m_RoomRecords[RoomIndex].bIsStreamingIn = false;
+
+			if (!SpawnedRoom)
+			{
+				return;
+			}
+
+			// the table holds the room's complete layout, including the blueprint's own doors, so it is applied as a whole
+			SpawnedRoom->ApplyDoorLayout(This->m_RoomTable.GetDoorLayout(RoomIndex));
+			This->InstallRoom(SpawnedRoom, RoomIndex);
+		};
+	}
+
+	m_StreamingSpawner->SpawnRooms(MoveTemp(SpawnInfos));
+}
+
+FRandomStream ADungeon::GetRoomRandomStream(int32 Seed, int32 RoomIndex)
+{
+	return FRandomStream{ static_cast<int32>(HashCombineFast(::GetTypeHash(Seed), ::GetTypeHash(RoomIndex))) };
+}
+
+FVector ADungeon::TileToWorld(const FIntPoint& Tile) const
+{
+	return GetActorLocation() + FVector{ Tile.X * m_TileSize, Tile.Y * m_TileSize, 0.0f };
+}
+
+FIntPoint ADungeon::WorldToTile(const FVector& WorldLocation) const
+{
+	const FVector LocalLocation{ WorldLocation - GetActorLocation() };
+	return { FMath::FloorToInt32(LocalLocation.X / m_TileSize), FMath::FloorToInt32(LocalLocation.Y / m_TileSize) };
+}
+
+FTileFootprint ADungeon::GetFootprint(const ADungeonRoom* Room) const
+{
+	// the location is offset by half a tile so that rooms placed exactly on a tile boundary are not rounded into the previous tile
+	const FVector HalfTile{ m_TileSize * 0.5f, m_TileSize * 0.5f, 0.0f };
+	return { WorldToTile(Room->GetActorLocation() + HalfTile), Room->GetWidth(), Room->GetLength() };
+}
+
+bool ADungeon::CanPlaceRoom(const FTileFootprint& Footprint) const
+{
+	return m_RoomGrid.IsAreaFree(Footprint);
+}
+
+ADungeonRoom* ADungeon::FindRoomAtLocation(const FVector& WorldLocation) const
+{
+	const int32 RoomIndex{ m_RoomGrid.FindRoomAt(WorldToTile(WorldLocation)) };
+	return RoomIndex != INDEX_NONE ? m_RoomsArray[RoomIndex] : nullptr;
+}
+
+void ADungeon::FindRoomsInBox(const FBox& WorldBox, TArray<ADungeonRoom*>& OutRooms) const
+{
+	const FIntPoint MinTile{ WorldToTile(WorldBox.Min) };
+	const FIntPoint MaxTile{ WorldToTile(WorldBox.Max) };
+	const FTileFootprint Box{ MinTile, MaxTile.Y - MinTile.Y + 1, MaxTile.X - MinTile.X + 1 };
+
+	TArray<int32> RoomIndices;
+	m_RoomGrid.FindRoomsInBox(Box, RoomIndices);
+
+	for (const int32 RoomIndex : RoomIndices)
+	{
+		// streamed-out rooms have no actor to return
+		if (ADungeonRoom* Room{ m_RoomsArray[RoomIndex] })
+		{
+			OutRooms.Add(Room);
+		}
+	}
+}
+
+ADungeonRoom* ADungeon::FindNeighbor(const ADungeonRoom* Room, const ADungeonRoom::FWallLocation& Location) const
+{
+	const int32 NeighborIndex{ m_RoomGrid.FindNeighbor(m_RoomIndices.FindChecked(Room), Location.WallDirection, Location.SegmentIndex) };
+	return NeighborIndex != INDEX_NONE ? m_RoomsArray[NeighborIndex] : nullptr;
+}
+
+void ADungeon::FindNeighbors(const ADungeonRoom* Room, TArray<ADungeonRoom*>& OutNeighbors) const
+{
+	TArray<int32> NeighborIndices;
+	m_RoomGrid.FindNeighbors(m_RoomIndices.FindChecked(Room), NeighborIndices);
+
+	for (const int32 NeighborIndex : NeighborIndices)
+	{
+		// streamed-out rooms have no actor to return
+		if (ADungeonRoom* NeighborRoom{ m_RoomsArray[NeighborIndex] })
+		{
+			OutNeighbors.Add(NeighborRoom);
+		}
+	}
+}
+
+const FDungeonRoomGraph& ADungeon::GetRoomGraph() const
+{
+	return m_RoomGraph;
+}
+
+bool ADungeon::AreRoomsConnected(const ADungeonRoom* RoomA, const ADungeonRoom* RoomB) const
+{
+	return m_RoomGraph.AreConnected(m_RoomIndices.FindChecked(RoomA), m_RoomIndices.FindChecked(RoomB));
+}
+
+bool ADungeon::IsFullyConnected() const
+{
+	return m_RoomGraph.IsFullyConnected();
+}
+
+int32 ADungeon::GetRoomDistance(const ADungeonRoom* RoomA, const ADungeonRoom* RoomB) const
+{
+	return m_RoomGraph.GetDistance(m_RoomIndices.FindChecked(RoomA), m_RoomIndices.FindChecked(RoomB));
+}
+
+int64 ADungeon::FMemoryReport::GetTotalBytes() const
+{
+	return ComponentBytes + RenderProxyBytes + AssetBytes + PrefetchedBytes + DatabaseBytes + BookkeepingBytes;
+}
+
+ADungeon::FMemoryReport ADungeon::GetMemoryReport() const
+{
+	FMemoryReport Report;
+	Report.Rooms.Reserve(m_RoomIndices.Num());
+
+	// meshes are shared between rooms, so they are gathered first and measured once each
+	TSet<UStaticMesh*> Meshes;
+	TArray<UStaticMesh*> RoomMeshes;
+
+	for (const ADungeonRoom* Room : m_RoomsArray)
+	{
+		if (!IsValid(Room))
+		{
+			++Report.NumStreamedOutRooms;
+			continue;
+		}
+
+		const ADungeonRoom::FMemoryReport& RoomReport{ Report.Rooms.Emplace_GetRef(Room, Room->GetMemoryReport()).Value };
+		Report.ComponentBytes	+= RoomReport.ComponentBytes;
+		Report.RenderProxyBytes += RoomReport.RenderProxyBytes;
+
+		RoomMeshes.Reset();
+		Room->GetSegmentMeshes(RoomMeshes);
+		Meshes.Append(RoomMeshes);
+	}
+
+	for (UStaticMesh* Mesh : Meshes)
+	{
+		Report.AssetBytes += Mesh->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+	}
+
+	// the dungeon's own components hold the instanced segments of every room that collapsed its own
+	TArray<UStaticMeshComponent*> Components;
+	GetComponents(Components);
+	for (UStaticMeshComponent* Component : Components)
+	{
+		Report.ComponentBytes += Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		if (const FPrimitiveSceneProxy* Proxy{ Component->SceneProxy })
+		{
+			Report.RenderProxyBytes += Proxy->GetMemoryFootprint();
+		}
+	}
+
+	Report.PrefetchedBytes = m_Prefetcher ? m_Prefetcher->GetLoadedBytes() : 0;
+	Report.DatabaseBytes   = m_RoomDatabase ? m_RoomDatabase->GetAllocatedSize() : 0;
+
+	Report.BookkeepingBytes = m_RoomsArray.GetAllocatedSize() + m_RoomIndices.GetAllocatedSize() + m_RoomRecords.GetAllocatedSize()
+		+ m_RoomTable.GetAllocatedSize() + m_RoomGrid.GetAllocatedSize() + m_RoomGraph.GetAllocatedSize()
+		+ m_ReplicatedRooms.Rooms.GetAllocatedSize() + m_ReplicationIDsByRoomIndex.GetAllocatedSize()
+		+ m_RoomIndicesByReplicationID.GetAllocatedSize() + m_ItemIndicesByReplicationID.GetAllocatedSize() + m_PendingReplicationIDs.GetAllocatedSize();
+
+	return Report;
+}
+
+void ADungeon::LogMemoryReport(bool bIncludeRooms) const
+{
+	const FMemoryReport Report{ GetMemoryReport() };
+
+	constexpr double BytesPerKilobyte{ 1024.0 };
+	UE_LOG(LogTemp, Log, TEXT("Dungeon memory report for %s: %.1f KB in total, %d rooms streamed in, %d streamed out"),
+		*GetName(), Report.GetTotalBytes() / BytesPerKilobyte, Report.Rooms.Num(), Report.NumStreamedOutRooms);
+	UE_LOG(LogTemp, Log, TEXT("  Components: %.1f KB, Render proxies: %.1f KB, Meshes: %.1f KB, Prefetched: %.1f KB, Database: %.1f KB, Bookkeeping: %.1f KB"),
+		Report.ComponentBytes / BytesPerKilobyte, Report.RenderProxyBytes / BytesPerKilobyte, Report.AssetBytes / BytesPerKilobyte,
+		Report.PrefetchedBytes / BytesPerKilobyte, Report.DatabaseBytes / BytesPerKilobyte, Report.BookkeepingBytes / BytesPerKilobyte);
+
+	if (!bIncludeRooms)
+	{
+		return;
+	}
+
+	for (const TPair<const ADungeonRoom*, ADungeonRoom::FMemoryReport>& Pair : Report.Rooms)
+	{
+		const ADungeonRoom::FMemoryReport& RoomReport{ Pair.Value };
+		UE_LOG(LogTemp, Log, TEXT("  %s: %d components (%.1f KB), %d render proxies (%.1f KB), %.1f KB of referenced meshes"),
+			*Pair.Key->GetName(), RoomReport.NumComponents, RoomReport.ComponentBytes / BytesPerKilobyte,
+			RoomReport.NumRenderProxies, RoomReport.RenderProxyBytes / BytesPerKilobyte, RoomReport.ReferencedAssetBytes / BytesPerKilobyte);
+	}
+}
+
+void ADungeon::HandleDoorChanged(ADungeonRoom* Room, const ADungeonRoom::FWallLocation& Location, bool bHasDoor)
+{
+	const int32 RoomIndex{ m_RoomIndices.FindChecked(Room) };
+	m_RoomTable.SetDoor(RoomIndex, Location.WallDirection, Location.SegmentIndex, bHasDoor);
+
+	if (HasAuthority())
+	{
+		UpdateReplicatedDoors(RoomIndex);
+	}
+
+	UpdateDoorConnection(RoomIndex, Location.WallDirection, Location.SegmentIndex, bHasDoor);
+}
+
+void ADungeon::UpdateDoorConnection(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex, bool bHasDoor)
+{
+	const FRoomDoor Door{ RoomIndex, Wall, SegmentIndex };
+
+	if (!bHasDoor)
+	{
+		m_RoomGraph.Disconnect(Door);
+		return;
+	}
+
+	const int32 NeighborIndex{ m_RoomGrid.FindNeighbor(RoomIndex, Wall, SegmentIndex) };
+	if (NeighborIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FRoomDoor FacingDoor{ NeighborIndex, FDungeonTileGrid::GetOppositeWall(Wall), m_RoomGrid.FindFacingSegment(RoomIndex, Wall, SegmentIndex) };
+
+	// a door only connects the rooms once the neighbor has a door on the facing segment as well
+	if (m_RoomTable.HasDoor(NeighborIndex, FacingDoor.Wall, FacingDoor.SegmentIndex))
+	{
+		m_RoomGraph.Connect(Door, FacingDoor);
+	}
+}
+
+void ADungeon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ADungeon, m_Seed);
+	DOREPLIFETIME(ADungeon, m_ReplicatedRooms);
+}
+
+void ADungeon::PostRepNotifies()
+{
+	Super::PostRepNotifies();
+
+	// applied only once every property of the update is in, so the rooms are spawned with the seed they were replicated with
+	ApplyReplicatedRooms();
+}
+
+void ADungeon::AddReplicatedRoom(int32 RoomIndex, const FSoftObjectPath& AssetPath, const FIntPoint& Origin, int32 LayoutIndex)
+{
+	const int32 AssetIndex{ m_RoomDatabase ? m_RoomDatabase->GetAssetIndex(AssetPath) : INDEX_NONE };
+	if (AssetIndex == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Warning: Room will not be replicated, since its asset is not in the dungeon's room database: %s"), 
+			*AssetPath.ToString());
+		return;
+	}
+
+	checkf(Origin.X >= MIN_int16 && Origin.X <= MAX_int16 && Origin.Y >= MIN_int16 && Origin.Y <= MAX_int16, TEXT("Error: Room is too far from the dungeon's origin to be replicated"));
+
+	const int32 ItemIndex{ m_ReplicatedRooms.Rooms.AddDefaulted() };
+	FReplicatedDungeonRoom& Item{ m_ReplicatedRooms.Rooms[ItemIndex] };
+	Item.AssetIndex  = AssetIndex;
+	Item.LayoutIndex = LayoutIndex;
+	Item.TileX 	 = static_cast<int16>(Origin.X);
+	Item.TileY 	 = static_cast<int16>(Origin.Y);
+	Item.SetDoorLayout(GetRoomDoorLayout(RoomIndex));
+
+	m_ReplicatedRooms.MarkItemDirty(Item);
+
+	m_ReplicationIDsByRoomIndex.Add(RoomIndex, Item.ReplicationID);
+	m_RoomIndicesByReplicationID.Add(Item.ReplicationID, RoomIndex);
+
+	// items are only ever appended, or removed all at once, so their positions stay valid until the rooms are released
+	m_ItemIndicesByReplicationID.Add(Item.ReplicationID, ItemIndex);
+}
+
+void ADungeon::UpdateReplicatedDoors(int32 RoomIndex)
+{
+	const int32* ReplicationID{ m_ReplicationIDsByRoomIndex.Find(RoomIndex) };
+	if (!ReplicationID)
+	{
+		return;
+	}
+
+	const int32* ItemIndex{ m_ItemIndicesByReplicationID.Find(*ReplicationID) };
+	FReplicatedDungeonRoom* Item{ ItemIndex ? &m_ReplicatedRooms.Rooms[*ItemIndex] : nullptr };
+
+	const FDoorLayout Layout{ GetRoomDoorLayout(RoomIndex) };
+	if (Item && Item->GetDoorLayout() != Layout)
+	{
+		Item->SetDoorLayout(Layout);
+		m_ReplicatedRooms.MarkItemDirty(*Item);
+	}
+}
+
+void ADungeon::OnReplicatedRoomChanged(int32 ReplicationID)
+{
+	m_PendingReplicationIDs.Add(ReplicationID);
+}
+
+void ADungeon::OnReplicatedRoomRemoved(int32 ReplicationID)
+{
+	// the server only ever removes every room at once, such as between floors
+	m_bHasRemovedReplicatedRooms = true;
+}
+
+void ADungeon::ApplyReplicatedRooms()
+{
+	if (HasAuthority() || !m_RoomDatabase)
+	{
+		return;
+	}
+
+	if (m_bHasRemovedReplicatedRooms)
+	{
+		ReleaseRooms();
+		m_bHasRemovedReplicatedRooms = false;
+
+		for (const FReplicatedDungeonRoom& Item : m_ReplicatedRooms.Rooms)
+		{
+			m_PendingReplicationIDs.Add(Item.ReplicationID);
+		}
+	}
+
+	if (m_PendingReplicationIDs.Num() == 0)
+	{
+		return;
+	}
+
+	for (const FReplicatedDungeonRoom& Item : m_ReplicatedRooms.Rooms)
+	{
+		if (!m_PendingReplicationIDs.Contains(Item.ReplicationID))
+		{
+			continue;
+		}
+
+		if (const int32* RoomIndex{ m_RoomIndicesByReplicationID.Find(Item.ReplicationID) })
+		{
+			SetRoomDoorLayout(*RoomIndex, Item.GetDoorLayout());
+		}
+		else if (ADungeonRoom* SpawnedRoom{ SpawnReplicatedRoom(Item) })
+		{
+			const int32 SpawnedRoomIndex{ m_RoomIndices.FindChecked(SpawnedRoom) };
+			m_ReplicationIDsByRoomIndex.Add(SpawnedRoomIndex, Item.ReplicationID);
+			m_RoomIndicesByReplicationID.Add(Item.ReplicationID, SpawnedRoomIndex);
+		}
+	}
+
+	m_PendingReplicationIDs.Reset();
+}
+
+ADungeonRoom* ADungeon::SpawnReplicatedRoom(const FReplicatedDungeonRoom& Item)
+{
+	const FSoftObjectPath* AssetPath{ m_RoomDatabase->FindAssetPath(Item.AssetIndex) };
+	UObject* LoadedAsset{ AssetPath ? AssetPath->TryLoad() : nullptr };
+	if (!LoadedAsset)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Failed to load the replicated room asset with index %d"), Item.AssetIndex);
+		return nullptr;
+	}
+
+	ADungeonRoom::FSpawnInfo SpawnInfo;
+	SpawnInfo.LoadedAsset  = LoadedAsset;
+	SpawnInfo.RoomLocation = TileToWorld({ Item.TileX, Item.TileY });
+	SpawnInfo.RandomStream = GetRoomRandomStream(m_Seed, Item.LayoutIndex);
+
+	// the item holds the room's complete layout, including the blueprint's own doors, so it is applied as a whole
+	ADungeonRoom* SpawnedRoom{ ADungeonRoom::Spawn(SpawnInfo, GetWorld()) };
+	SpawnedRoom->ApplyDoorLayout(Item.GetDoorLayout());
+
+	AddRoom(SpawnedRoom);
+	m_RoomRecords[m_RoomIndices.FindChecked(SpawnedRoom)].AssetPath = *AssetPath;
+	return SpawnedRoom;
 }
 
 // Called when the game starts or when spawned
 void ADungeon::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	if (m_bStreamRooms)
+	{
+		SetActorTickInterval(m_StreamingInterval);
+		SetActorTickEnabled(true);
+	}
+}
+
+void ADungeon::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// every local or remote player streams in their own neighborhood
+	TArray<FVector, TInlineAllocator<8>> ViewerLocations;
+	for (FConstPlayerControllerIterator Iterator{ GetWorld()->GetPlayerControllerIterator() }; Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController{ Iterator->Get() };
+		if (const APawn* Pawn{ PlayerController ? PlayerController->GetPawn() : nullptr })
+		{
+			ViewerLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	UpdateStreaming(ViewerLocations);
+}
+
+void ADungeon::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// pending rooms must not be installed into a dungeon that is going away
+	m_StreamingSpawner.Reset();
+	m_Prefetcher.Reset();
+	CancelSnapshotRestore();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 
@@ -0,0 +1,95 @@
+#include "DungeonLayout.h"
+
+#include "Dungeon/Rooms/RoomLayout.h"
+
+bool FDungeonLayout::CanPlaceRoom(const FTileFootprint& Footprint) const
+{
+	return m_Grid.IsAreaFree(Footprint);
+}
+
+int32 FDungeonLayout::AddRoom(const FSoftObjectPath& AssetPath, const FDungeonRoomSpecs& Specs, const FTileFootprint& Footprint, const FDoorLayout& DoorSlots)
+{
+	checkf(Footprint.Width == Specs.Dimensions.Width && Footprint.Length == Specs.Dimensions.Length, 
+		TEXT("Error: Room footprint does not match the dimensions of its asset: %s"), *AssetPath.ToString());
+
+	// the common footprints check every wall against a constant mask
+	const bool bAreSlotsInWalls{ VisitRoomLayout(Footprint.Width, Footprint.Length, FDoorLayout{ }, [&DoorSlots](const auto& RoomLayout)
+	{
+		return RoomLayout.IsValidLayout(DoorSlots);
+	}) };
+	checkf(bAreSlotsInWalls, TEXT("Error: Room has door slots outside of its walls: %s"), *AssetPath.ToString());
+
+	const int32 RoomIndex{ m_Rooms.Add(FDungeonLayoutRoom{ AssetPath, Specs, Footprint, FDoorLayout{ }, DoorSlots }) };
+	m_Grid.AddRoom(RoomIndex, Footprint);
+
+	return RoomIndex;
+}
+
+bool FDungeonLayout::IsValidWallLocation(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex) const
+{
+	const FDungeonLayoutRoom& Room{ m_Rooms[RoomIndex] };
+	return VisitRoomLayout(Room.Footprint.Width, Room.Footprint.Length, Room.Doors, [Wall, SegmentIndex](const auto& RoomLayout)
+	{
+		return RoomLayout.IsValidWallLocation(Wall, SegmentIndex);
+	});
+}
+
+bool FDungeonLayout::IsFreeDoorSlot(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex) const
+{
+	const FDungeonLayoutRoom& Room{ m_Rooms[RoomIndex] };
+	return VisitRoomLayout(Room.Footprint.Width, Room.Footprint.Length, Room.Doors, [&Room, Wall, SegmentIndex](const auto& RoomLayout)
+	{
+		return RoomLayout.IsFreeDoorSlot(Room.DoorSlots, Wall, SegmentIndex);
+	});
+}
+
+bool FDungeonLayout::ConnectRooms(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex)
+{
+	checkf(IsValidWallLocation(RoomIndex, Wall, SegmentIndex), TEXT("Error: Attempted to add a door to an invalid location"));
+
+	const int32 NeighborIndex{ m_Grid.FindNeighbor(RoomIndex, Wall, SegmentIndex) };
+	if (NeighborIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const EDirection FacingWall{ FDungeonTileGrid::GetOppositeWall(Wall) };
+	const int32 FacingSegmentIndex{ m_Grid.FindFacingSegment(RoomIndex, Wall, SegmentIndex) };
+
+	if (!IsFreeDoorSlot(RoomIndex, Wall, SegmentIndex) || !IsFreeDoorSlot(NeighborIndex, FacingWall, FacingSegmentIndex))
+	{
+		return false;
+	}
+
+	m_Rooms[RoomIndex].Doors.AddDoor(Wall, SegmentIndex);
+	m_Rooms[NeighborIndex].Doors.AddDoor(FacingWall, FacingSegmentIndex);
+
+	return true;
+}
+
+const TArray<FDungeonLayoutRoom>& FDungeonLayout::GetRooms() const
+{
+	return m_Rooms;
+}
+
+const FDungeonTileGrid& FDungeonLayout::GetGrid() const
+{
+	return m_Grid;
+}
+
+int32 FDungeonLayout::Num() const
+{
+	return m_Rooms.Num();
+}
+
+void FDungeonLayout::Reserve(int32 NumRooms, int32 NumTiles)
+{
+	m_Rooms.Reserve(NumRooms);
+	m_Grid.Reserve(NumRooms, NumTiles);
+}
+
+void FDungeonLayout::Reset()
+{
+	m_Rooms.Reset();
+	m_Grid.Reset();
+}
@@ -0,0 +1,192 @@
+#include "DungeonLayoutGenerator.h"
+
+FDungeonLayoutGenerator::FDungeonLayoutGenerator(const FDungeonRoomDatabase& Database, const FSettings& Settings)
+	: m_Database{ Database }
+	, m_Settings{ Settings }
+{
+	// generators are typically created on the game thread and then used from workers, which must not wait on lazily rebuilt data
+	m_Database.PrepareForConcurrentReads();
+
+	m_Database.GetRoomSpecs(m_Settings.Theme, m_CandidateSpecs);
+
+	// the database's map order is not guaranteed, so the specs are sorted to keep generation deterministic for a given seed
+	m_CandidateSpecs.Sort([](const FDungeonRoomSpecs& A, const FDungeonRoomSpecs& B)
+	{
+		const int32 WidthA{ A.Dimensions.Width };
+		const int32 WidthB{ B.Dimensions.Width };
+		const int32 LengthA{ A.Dimensions.Length };
+		const int32 LengthB{ B.Dimensions.Length };
+		return WidthA != WidthB ? WidthA < WidthB : LengthA < LengthB;
+	});
+
+	for (const FDungeonRoomSpecs& Specs : m_CandidateSpecs)
+	{
+		const int32 Width{ Specs.Dimensions.Width };
+		const int32 Length{ Specs.Dimensions.Length };
+		m_MaxRoomArea = FMath::Max(m_MaxRoomArea, Width * Length);
+	}
+}
+
+bool FDungeonLayoutGenerator::Generate(int32 Seed, FDungeonLayout& OutLayout) const
+{
+	OutLayout.Reset();
+
+	if (m_CandidateSpecs.Num() == 0 || m_Settings.NumRooms <= 0)
+	{
+		return m_Settings.NumRooms <= 0;
+	}
+
+	OutLayout.Reserve(m_Settings.NumRooms, m_Settings.NumRooms * m_MaxRoomArea);
+
+	FRandomStream RandomStream{ Seed };
+	FAssetBudget Budget;
+	if (!PlaceFirstRoom(RandomStream, OutLayout, Budget))
+	{
+		return false;
+	}
+
+	while (OutLayout.Num() < m_Settings.NumRooms)
+	{
+		bool bHasPlacedRoom{ false };
+		for (int32 Attempt{ 0 }; Attempt < m_Settings.MaxAttemptsPerRoom && !bHasPlacedRoom; ++Attempt)
+		{
+			bHasPlacedRoom = TryPlaceRoom(RandomStream, OutLayout, Budget);
+		}
+
+		if (!bHasPlacedRoom)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int64 FDungeonLayoutGenerator::GetEstimatedAssetSize(const FDungeonLayout& Layout) const
+{
+	TSet<FSoftObjectPath, DefaultKeyFuncs<FSoftObjectPath>, TInlineSetAllocator<16>> AssetPaths;
+	int64 EstimatedSize{ 0 };
+	for (const FDungeonLayoutRoom& Room : Layout.GetRooms())
+	{
+		bool bIsAlreadyInSet{ false };
+		AssetPaths.Add(Room.AssetPath, &bIsAlreadyInSet);
+		if (!bIsAlreadyInSet)
+		{
+			EstimatedSize += m_Database.GetEstimatedAssetSize(Room.AssetPath);
+		}
+	}
+	return EstimatedSize;
+}
+
+void FDungeonLayoutGenerator::FAssetBudget::Add(const FSoftObjectPath& AssetPath, const FDungeonRoomSpecs& Specs, int64 EstimatedSize)
+{
+	if (!UsedAssets.Contains(AssetPath))
+	{
+		UsedAssets.Add(AssetPath);
+		UsedSpecs.Add(Specs);
+		UsedBytes += EstimatedSize;
+	}
+}
+
+bool FDungeonLayoutGenerator::PlaceFirstRoom(FRandomStream& RandomStream, FDungeonLayout& Layout, FAssetBudget& Budget) const
+{
+	const FDungeonRoomSpecs& Specs{ m_CandidateSpecs[RandomStream.RandHelper(m_CandidateSpecs.Num())] };
+	const FSoftObjectPath* AssetPath{ SampleAssetWithinBudget(Specs, FDoorLayout{ }, RandomStream, Budget) };
+	if (!AssetPath)
+	{
+		return false;
+	}
+
+	Layout.AddRoom(*AssetPath, Specs, FTileFootprint{ { 0, 0 }, Specs.Dimensions.Width, Specs.Dimensions.Length }, *m_Database.FindDoorSlots(*AssetPath));
+	Budget.Add(*AssetPath, Specs, m_Database.GetEstimatedAssetSize(*AssetPath));
+
+	return true;
+}
+
+bool FDungeonLayoutGenerator::TryPlaceRoom(FRandomStream& RandomStream, FDungeonLayout& Layout, FAssetBudget& Budget) const
+{
+	const int32 RoomIndex{ RandomStream.RandHelper(Layout.Num()) };
+	const FDungeonLayoutRoom& Room{ Layout.GetRooms()[RoomIndex] };
+
+	const EDirection Wall{ FDoorLayout::WallDirections[RandomStream.RandHelper(FDoorLayout::NumWalls)] };
+	const int32 SegmentIndex{ RandomStream.RandHelper(Room.Footprint.GetNumSegments(Wall)) };
+
+	// a segment that cannot hold a door or already leads somewhere cannot host the new room
+	if (!Layout.IsFreeDoorSlot(RoomIndex, Wall, SegmentIndex) || Layout.GetGrid().FindNeighbor(RoomIndex, Wall, SegmentIndex) != INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FDungeonRoomSpecs& Specs{ m_CandidateSpecs[RandomStream.RandHelper(m_CandidateSpecs.Num())] };
+
+	const EDirection FacingWall{ FDungeonTileGrid::GetOppositeWall(Wall) };
+	const FIntPoint TileAcross{ Room.Footprint.GetTileAcrossSegment(Wall, SegmentIndex) };
+
+	const int32 NumFacingSegments{ FTileFootprint{ { 0, 0 }, Specs.Dimensions.Width, Specs.Dimensions.Length }.GetNumSegments(FacingWall) };
+	const int32 FacingSegmentIndex{ RandomStream.RandHelper(NumFacingSegments) };
+	const FTileFootprint Footprint{ GetFootprintFacingTile(Specs, FacingWall, FacingSegmentIndex, TileAcross) };
+
+	if (!Layout.CanPlaceRoom(Footprint))
+	{
+		return false;
+	}
+
+	// only assets that can hold the connecting door are sampled, so specs whose assets rarely allow it still get placed
+	FDoorLayout ConnectingDoor;
+	ConnectingDoor.AddDoor(FacingWall, FacingSegmentIndex);
+
+	const FSoftObjectPath* AssetPath{ SampleAssetWithinBudget(Specs, ConnectingDoor, RandomStream, Budget) };
+	if (!AssetPath)
+	{
+		return false;
+	}
+
+	Layout.AddRoom(*AssetPath, Specs, Footprint, *m_Database.FindDoorSlots(*AssetPath));
+	Budget.Add(*AssetPath, Specs, m_Database.GetEstimatedAssetSize(*AssetPath));
+
+	const bool bIsConnected{ Layout.ConnectRooms(RoomIndex, Wall, SegmentIndex) };
+	checkf(bIsConnected, TEXT("Error: Failed to connect a room placed across a free segment"));
+
+	return true;
+}
+
+const FSoftObjectPath* FDungeonLayoutGenerator::SampleAssetWithinBudget(const FDungeonRoomSpecs& Specs, const FDoorLayout& RequiredDoors, FRandomStream& RandomStream, const FAssetBudget& Budget) const
+{
+	const FSoftObjectPath* AssetPath{ m_Database.SampleAssetPathAllowingDoors(Specs, RequiredDoors, RandomStream) };
+	if (!AssetPath)
+	{
+		return nullptr;
+	}
+
+	// without a budget, no further numbers are drawn, so layouts match those generated before budgets existed
+	if (m_Settings.AssetMemoryBudgetBytes <= 0 || Budget.UsedAssets.Contains(*AssetPath)
+		|| Budget.UsedBytes + m_Database.GetEstimatedAssetSize(*AssetPath) <= m_Settings.AssetMemoryBudgetBytes)
+	{
+		return AssetPath;
+	}
+
+	// reusing an asset already in the layout costs nothing, so the layout is simplified rather than rejected outright
+	TArray<int32, TInlineAllocator<16>> ReusableIndices;
+	for (int32 UsedIndex{ 0 }; UsedIndex < Budget.UsedSpecs.Num(); ++UsedIndex)
+	{
+		if (Budget.UsedSpecs[UsedIndex] == Specs && m_Database.FindDoorSlots(Budget.UsedAssets[UsedIndex])->Contains(RequiredDoors))
+		{
+			ReusableIndices.Add(UsedIndex);
+		}
+	}
+
+	if (ReusableIndices.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	return &Budget.UsedAssets[ReusableIndices[RandomStream.RandHelper(ReusableIndices.Num())]];
+}
+
+FTileFootprint FDungeonLayoutGenerator::GetFootprintFacingTile(const FDungeonRoomSpecs& Specs, const EDirection Wall, const int32 SegmentIndex, const FIntPoint& Tile)
+{
+	// the segment's tile of a footprint at the origin is exactly the offset from the footprint's origin to that tile
+	FTileFootprint Footprint{ { 0, 0 }, Specs.Dimensions.Width, Specs.Dimensions.Length };
+	Footprint.Origin = Tile - Footprint.GetSegmentTile(Wall, SegmentIndex);
+	return Footprint;
+}
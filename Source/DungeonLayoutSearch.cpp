@@ -0,0 +1,98 @@
+#include "DungeonLayoutSearch.h"
+
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+
+FDungeonLayoutSearch::FDungeonLayoutSearch(const FDungeonLayoutGenerator& Generator, FScoreFunction ScoreFunction, float TargetScore)
+	: m_Generator{ Generator }
+	, m_ScoreFunction{ MoveTemp(ScoreFunction) }
+	, m_TargetScore{ TargetScore }
+{
+	checkf(m_ScoreFunction, TEXT("Error: Attempted to create a layout search without a score function"));
+}
+
+TOptional<FDungeonLayoutSearch::FCandidate> FDungeonLayoutSearch::Run(int32 FirstSeed, int32 NumCandidates)
+{
+	m_bIsCancelled = false;
+	return Search(FirstSeed, NumCandidates);
+}
+
+TFuture<TOptional<FDungeonLayoutSearch::FCandidate>> FDungeonLayoutSearch::RunAsync(int32 FirstSeed, int32 NumCandidates)
+{
+	// reset before launching, so that a Cancel() issued before the task starts is not lost
+	m_bIsCancelled = false;
+
+	return Async(EAsyncExecution::TaskGraph, [this, FirstSeed, NumCandidates]()
+	{
+		return Search(FirstSeed, NumCandidates);
+	});
+}
+
+void FDungeonLayoutSearch::Cancel()
+{
+	m_bIsCancelled = true;
+}
+
+bool FDungeonLayoutSearch::IsCancelled() const
+{
+	return m_bIsCancelled;
+}
+
+TOptional<FDungeonLayoutSearch::FCandidate> FDungeonLayoutSearch::Search(int32 FirstSeed, int32 NumCandidates)
+{
+	TOptional<FCandidate> Best;
+	FCriticalSection BestLock;
+
+	// checked on every search, as the number of workers can change between searches (e.g. when the task graph is reconfigured)
+	const int32 NumContexts{ FTaskGraphInterface::Get().GetNumWorkerThreads() + 1 };
+	if (m_WorkerLayouts.Num() < NumContexts)
+	{
+		m_WorkerLayouts.SetNum(NumContexts);
+	}
+
+	// each worker generates into its own layout, which only has to be copied when the candidate is the best so far
+	// a whole layout is generated per candidate, so candidates are handed out one at a time to balance the workers
+	constexpr int32 MinBatchSize{ 1 };
+	ParallelForWithExistingTaskContext(MakeArrayView(m_WorkerLayouts.GetData(), NumContexts), NumCandidates, MinBatchSize,
+		[this, FirstSeed, &Best, &BestLock](FDungeonLayout& Layout, int32 CandidateIndex)
+	{
+		if (m_bIsCancelled.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		const int32 Seed{ FirstSeed + CandidateIndex };
+		if (!m_Generator.Generate(Seed, Layout))
+		{
+			return;
+		}
+		const float Score{ m_ScoreFunction(Layout) };
+
+		if (Score >= m_TargetScore)
+		{
+			m_bIsCancelled = true;
+		}
+
+		// candidates take far longer to generate than to compare, so a single lock sees little contention
+		FScopeLock Lock{ &BestLock };
+		if (!Best.IsSet())
+		{
+			Best.Emplace(FCandidate{ Layout, Seed, Score });
+		}
+		else if (IsBetterCandidate(Seed, Score, Best.GetValue()))
+		{
+			FCandidate& BestCandidate{ Best.GetValue() };
+			BestCandidate.Layout = Layout; // copied into the existing layout, so its arrays are only regrown when the new layout is larger
+			BestCandidate.Seed   = Seed;
+			BestCandidate.Score  = Score;
+		}
+	});
+
+	return Best;
+}
+
+bool FDungeonLayoutSearch::IsBetterCandidate(int32 Seed, float Score, const FCandidate& Best)
+{
+	return Score > Best.Score || (Score == Best.Score && Seed < Best.Seed);
+}
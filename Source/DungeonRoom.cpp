@@ -1,9 +1,19 @@
 #include "DungeonRoom.h"
 
 #include "System/BaseBlueprintAssetAnalyzer.h"
+#include "Dungeon/Rooms/DungeonRoomPool.h"
+#include "Dungeon/DungeonStats.h"
 #include "Dungeon/SegmentedWall.h"
 #include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "PrimitiveSceneProxy.h"
 #include "Dungeon/Enums/Direction.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	constexpr int32 MinRoomsForParallelPlanning{ 32 }; // below this, planning on worker threads costs more than it saves
+}
 
 ADungeonRoom::ADungeonRoom()
 {
@@ -34,7 +44,157 @@ USegmentedWall* ADungeonRoom::GetWall(const EDirection Direction) const
 void ADungeonRoom::SetStaticMesh(const FWallLocation& Location, UStaticMesh* NewMesh)
 {
 	USegmentedWall* WallBeingUpdated{ GetWall(Location.WallDirection) };
-	WallBeingUpdated->GetSegment(Location.SegmentIndex)->SetStaticMesh(NewMesh);
+	SetStaticMesh(WallBeingUpdated->GetSegment(Location.SegmentIndex), GetSegmentSlot(Location), NewMesh);
+}
+
+void ADungeonRoom::SetStaticMesh(UStaticMeshComponent* Segment, int32 SegmentSlot, UStaticMesh* NewMesh)
+{
+	INC_DWORD_STAT(STAT_DungeonMeshesSwapped);
+
+	if (m_SegmentRenderer)
+	{
+		m_SegmentRenderer->SetSegmentMesh(Segment, NewMesh);
+	}
+	else if (m_bIsFinalized && m_MergedSegments->ContainsSegment(Segment))
+	{
+		// only the changed segment leaves its batch; the mesh is set before registering so the segment is only registered once
+		m_MergedSegments->RemoveSegment(Segment);
+		Segment->SetStaticMesh(NewMesh);
+		Segment->RegisterComponent();
+	}
+	else if (m_CompanionSegments.Num() > 0)
+	{
+		const bool bIsCompanionShown{ m_IsCompanionShown[SegmentSlot] };
+		UStaticMeshComponent* ShownSegment{ bIsCompanionShown ? m_CompanionSegments[SegmentSlot] : Segment };
+		UStaticMeshComponent* HiddenSegment{ bIsCompanionShown ? Segment : m_CompanionSegments[SegmentSlot] };
+
+		if (ShownSegment->GetStaticMesh() == NewMesh)
+		{
+			return;
+		}
+
+		// the hidden component already holds the mesh whenever the segment toggles between its cached door and wall
+		if (HiddenSegment->GetStaticMesh() != NewMesh)
+		{
+			HiddenSegment->SetStaticMesh(NewMesh);
+		}
+
+		HiddenSegment->SetCollisionEnabled(ShownSegment->GetCollisionEnabled());
+		HiddenSegment->SetVisibility(true);
+		ShownSegment->SetVisibility(false);
+		ShownSegment->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+		m_IsCompanionShown[SegmentSlot] = !bIsCompanionShown;
+	}
+	else
+	{
+		Segment->SetStaticMesh(NewMesh);
+	}
+}
+
+void ADungeonRoom::EnableInstancedRendering(UInstancedSegmentRenderer* Renderer)
+{
+	checkf(Renderer, TEXT("Error: Attempted to enable instanced rendering without a renderer: %s"), *GetPathName());
+
+	checkf(!m_SegmentRenderer, TEXT("Error: Instanced rendering is already enabled: %s"), *GetPathName());
+
+	// the renderer takes over every segment, merged or not, and only draws the segments themselves
+	RestoreSegments();
+	CollapseCompanionSegments();
+
+	m_SegmentRenderer = Renderer;
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		USegmentedWall* Wall{ GetWall(Direction) };
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < Wall->GetNumSegments(); ++SegmentIndex)
+		{
+			m_SegmentRenderer->AddSegment(Wall->GetSegment(SegmentIndex));
+		}
+	}
+}
+
+void ADungeonRoom::DisableInstancedRendering()
+{
+	if (!m_SegmentRenderer)
+	{
+		return;
+	}
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		USegmentedWall* Wall{ GetWall(Direction) };
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < Wall->GetNumSegments(); ++SegmentIndex)
+		{
+			USegmentedWall::UWallSegment* Segment{ Wall->GetSegment(SegmentIndex) };
+			m_SegmentRenderer->RemoveSegment(Segment);
+			Segment->RegisterComponent();
+		}
+	}
+
+	m_SegmentRenderer = nullptr;
+}
+
+void ADungeonRoom::FinalizeSegments()
+{
+	if (m_SegmentRenderer)
+	{
+		return;
+	}
+
+	if (!m_MergedSegments)
+	{
+		m_MergedSegments = NewObject<UInstancedSegmentRenderer>(this, TEXT("MergedSegments"));
+		m_MergedSegments->SetupAttachment(m_Root);
+		m_MergedSegments->RegisterComponent();
+	}
+
+	// the merged batches only draw the segments themselves
+	CollapseCompanionSegments();
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		USegmentedWall* Wall{ GetWall(Direction) };
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < Wall->GetNumSegments(); ++SegmentIndex)
+		{
+			USegmentedWall::UWallSegment* Segment{ Wall->GetSegment(SegmentIndex) };
+			if (!m_MergedSegments->ContainsSegment(Segment))
+			{
+				m_MergedSegments->AddSegment(Segment);
+			}
+		}
+	}
+
+	m_bIsFinalized = true;
+}
+
+void ADungeonRoom::RestoreSegments()
+{
+	if (!m_bIsFinalized)
+	{
+		return;
+	}
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		USegmentedWall* Wall{ GetWall(Direction) };
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < Wall->GetNumSegments(); ++SegmentIndex)
+		{
+			USegmentedWall::UWallSegment* Segment{ Wall->GetSegment(SegmentIndex) };
+			if (m_MergedSegments->ContainsSegment(Segment))
+			{
+				m_MergedSegments->RemoveSegment(Segment);
+				Segment->RegisterComponent();
+			}
+		}
+	}
+
+	m_bIsFinalized = false;
+}
+
+bool ADungeonRoom::IsFinalized() const
+{
+	return m_bIsFinalized;
 }
 
 bool ADungeonRoom::IsValidWallLocation(const FWallLocation& Location) const
@@ -43,56 +203,554 @@ bool ADungeonRoom::IsValidWallLocation(const FWallLocation& Location) const
 	return Wall->IsValidSegmentIndex(Location.SegmentIndex);
 }
 
-UStaticMesh* ADungeonRoom::GetRandomMesh(TArray<UStaticMesh*> Meshes) const
+int32 ADungeonRoom::GetSegmentSlot(const FWallLocation& Location) const
 {
-	return Meshes[FMath::RandRange(0, Meshes.Num() - 1)];
+	int32 SegmentSlot{ static_cast<int32>(Location.SegmentIndex) };
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		if (Direction == Location.WallDirection)
+		{
+			return SegmentSlot;
+		}
+		SegmentSlot += GetWall(Direction)->GetNumSegments();
+	}
+
+	checkf(false, TEXT("Error: Invalid argument given to GetSegmentSlot()"));
+	return INDEX_NONE;
+}
+
+UStaticMesh* ADungeonRoom::ChooseSegmentMesh(const FWallLocation& Location, bool bIsDoor, const FRandomStream& RandomStream) const
+{
+	return ChooseSegmentMesh(GetSegmentSlot(Location), bIsDoor, RandomStream);
+}
+
+UStaticMesh* ADungeonRoom::ChooseSegmentMesh(int32 SegmentSlot, bool bIsDoor, const FRandomStream& RandomStream) const
+{
+	const TArray<UStaticMesh*>& CachedMeshes{ bIsDoor ? m_CachedDoorMeshes : m_CachedWallMeshes };
+	if (CachedMeshes.IsValidIndex(SegmentSlot) && CachedMeshes[SegmentSlot])
+	{
+		return CachedMeshes[SegmentSlot];
+	}
+
+	const TArray<UStaticMesh*>& Meshes{ bIsDoor ? m_DoorMeshes : m_WallMeshes };
+	return Meshes[RandomStream.RandHelper(Meshes.Num())];
+}
+
+void ADungeonRoom::CacheSegmentMesh(const FWallLocation& Location, bool bIsDoor, UStaticMesh* Mesh)
+{
+	CacheSegmentMesh(GetSegmentSlot(Location), bIsDoor, Mesh);
+}
+
+void ADungeonRoom::CacheSegmentMesh(int32 SegmentSlot, bool bIsDoor, UStaticMesh* Mesh)
+{
+	TArray<UStaticMesh*>& CachedMeshes{ bIsDoor ? m_CachedDoorMeshes : m_CachedWallMeshes };
+	if (CachedMeshes.IsValidIndex(SegmentSlot))
+	{
+		CachedMeshes[SegmentSlot] = Mesh;
+	}
+}
+
+void ADungeonRoom::InitializeSegmentMeshCache()
+{
+	int32 NumSegments{ 0 };
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		NumSegments += GetWall(Direction)->GetNumSegments();
+	}
+
+	m_CachedDoorMeshes.Init(nullptr, NumSegments);
+	m_CachedWallMeshes.Init(nullptr, NumSegments);
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < GetWall(Direction)->GetNumSegments(); ++SegmentIndex)
+		{
+			const FWallLocation Location{ Direction, SegmentIndex };
+			CacheSegmentMesh(Location, m_DoorLayout.HasDoor(Direction, SegmentIndex), GetSegmentMesh(Location));
+		}
+	}
+}
+
+void ADungeonRoom::InitializeDefaultSegmentMeshes()
+{
+	m_DefaultSegmentMeshes.Reset();
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < GetWall(Direction)->GetNumSegments(); ++SegmentIndex)
+		{
+			m_DefaultSegmentMeshes.Add(GetSegmentMesh({ Direction, SegmentIndex }));
+		}
+	}
+}
+
+void ADungeonRoom::RestoreDefaultSegmentMeshes()
+{
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < GetWall(Direction)->GetNumSegments(); ++SegmentIndex)
+		{
+			const FWallLocation Location{ Direction, SegmentIndex };
+			UStaticMesh* DefaultMesh{ m_DefaultSegmentMeshes[GetSegmentSlot(Location)] };
+			if (GetSegmentMesh(Location) != DefaultMesh)
+			{
+				SetStaticMesh(Location, DefaultMesh);
+			}
+		}
+	}
+}
+
+void ADungeonRoom::EnableDualSegments()
+{
+	m_bUseDualSegments = true;
+
+	if (m_CompanionSegments.Num() == 0)
+	{
+		CreateCompanionSegments();
+	}
+}
+
+void ADungeonRoom::CreateCompanionSegments()
+{
+	m_CompanionSegments.Reset();
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		USegmentedWall* Wall{ GetWall(Direction) };
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < Wall->GetNumSegments(); ++SegmentIndex)
+		{
+			const USegmentedWall::UWallSegment* Segment{ Wall->GetSegment(SegmentIndex) };
+
+			// attached to the root rather than the wall, so that the wall's children remain exactly its tagged segments
+			UStaticMeshComponent* Companion{ NewObject<UStaticMeshComponent>(this) };
+			Companion->SetupAttachment(m_Root);
+			Companion->SetRelativeTransform(Segment->GetComponentTransform().GetRelativeTransform(m_Root->GetComponentTransform()));
+			Companion->SetCollisionProfileName(Segment->GetCollisionProfileName());
+			Companion->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			Companion->SetVisibility(false);
+			Companion->RegisterComponent();
+
+			m_CompanionSegments.Add(Companion);
+		}
+	}
+
+	m_IsCompanionShown.Init(false, m_CompanionSegments.Num());
+}
+
+void ADungeonRoom::CollapseCompanionSegments()
+{
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		USegmentedWall* Wall{ GetWall(Direction) };
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < Wall->GetNumSegments(); ++SegmentIndex)
+		{
+			const int32 SegmentSlot{ GetSegmentSlot({ Direction, SegmentIndex }) };
+			if (!m_IsCompanionShown.IsValidIndex(SegmentSlot) || !m_IsCompanionShown[SegmentSlot])
+			{
+				continue;
+			}
+
+			USegmentedWall::UWallSegment* Segment{ Wall->GetSegment(SegmentIndex) };
+			UStaticMeshComponent* Companion{ m_CompanionSegments[SegmentSlot] };
+
+			Segment->SetStaticMesh(Companion->GetStaticMesh());
+			Segment->SetCollisionEnabled(Companion->GetCollisionEnabled());
+			Segment->SetVisibility(true);
+			Companion->SetVisibility(false);
+			Companion->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+			m_IsCompanionShown[SegmentSlot] = false;
+		}
+	}
+}
+
+UStaticMesh* ADungeonRoom::GetSegmentMesh(const FWallLocation& Location) const
+{
+	const int32 SegmentSlot{ GetSegmentSlot(Location) };
+	if (m_IsCompanionShown.IsValidIndex(SegmentSlot) && m_IsCompanionShown[SegmentSlot])
+	{
+		return m_CompanionSegments[SegmentSlot]->GetStaticMesh();
+	}
+
+	return GetWall(Location.WallDirection)->GetSegment(Location.SegmentIndex)->GetStaticMesh();
+}
+
+void ADungeonRoom::SetRandomStream(const FRandomStream& RandomStream)
+{
+	m_RandomStream = RandomStream;
+}
+
+const FRandomStream& ADungeonRoom::GetRandomStream() const
+{
+	return m_RandomStream;
 }
 
 ADungeonRoom* ADungeonRoom::Spawn(const FSpawnInfo& SpawnInfo, UWorld* World)
 {
+	DUNGEON_SCOPE_CYCLE_COUNTER(STAT_DungeonRoomSpawn);
+
+	ADungeonRoom* SpawnedRoom{ SpawnWithoutDoors(SpawnInfo, World) };
+	SpawnedRoom->ApplyDoorLayout(AddSpawnDoors(SpawnedRoom->GetDoorLayout(), SpawnInfo));
+
+	return SpawnedRoom;
+}
+
+void ADungeonRoom::SpawnBatch(TConstArrayView<FSpawnInfo> SpawnInfos, UWorld* World, TArray<ADungeonRoom*>& OutRooms)
+{
+	DUNGEON_SCOPE_CYCLE_COUNTER(STAT_DungeonRoomSpawnBatch);
+
+	// actors can only be created on the game thread
+	const int32 FirstRoomIndex{ OutRooms.Num() };
+	OutRooms.Reserve(FirstRoomIndex + SpawnInfos.Num());
+	for (const FSpawnInfo& SpawnInfo : SpawnInfos)
+	{
+		OutRooms.Add(SpawnWithoutDoors(SpawnInfo, World));
+	}
+
+	// planning only reads each room and writes to its own plan, and the game thread waits, so nothing modifies the rooms meanwhile
+	TArray<FDoorLayoutPlan> Plans;
+	Plans.SetNum(SpawnInfos.Num());
+	ParallelFor(SpawnInfos.Num(), [&SpawnInfos, &OutRooms, &Plans, FirstRoomIndex](int32 SpawnIndex)
+	{
+		const ADungeonRoom* Room{ OutRooms[FirstRoomIndex + SpawnIndex] };
+		const FSpawnInfo& SpawnInfo{ SpawnInfos[SpawnIndex] };
+
+		Room->PlanDoorLayout(AddSpawnDoors(Room->GetDoorLayout(), SpawnInfo), SpawnInfo.RandomStream, Plans[SpawnIndex]);
+	}, SpawnInfos.Num() < MinRoomsForParallelPlanning ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	// components can only be modified on the game thread, so every plan is applied in one pass without further lookups
+	for (int32 SpawnIndex{ 0 }; SpawnIndex < SpawnInfos.Num(); ++SpawnIndex)
+	{
+		OutRooms[FirstRoomIndex + SpawnIndex]->ApplyDoorLayoutPlan(Plans[SpawnIndex]);
+	}
+}
+
+ADungeonRoom* ADungeonRoom::SpawnWithoutDoors(const FSpawnInfo& SpawnInfo, UWorld* World)
+{
+	INC_DWORD_STAT(STAT_DungeonRoomsSpawned);
+
 	UClass* SpawnableClass { FBaseBlueprintAssetAnalyzer::GetSpawnableClass(SpawnInfo.LoadedAsset) };
 
-	ADungeonRoom* SpawnedRoom{ World->SpawnActor<ADungeonRoom>(SpawnableClass, SpawnInfo.RoomLocation, FRotator())};
-	
-	for (auto Location : SpawnInfo.DoorLocations)
+	UDungeonRoomPool* Pool{ World->GetSubsystem<UDungeonRoomPool>() };
+	ADungeonRoom* SpawnedRoom{ Pool ? Pool->Acquire(SpawnableClass, SpawnInfo.RoomLocation) : nullptr };
+	if (!SpawnedRoom)
 	{
-		SpawnedRoom->AddDoor(Location);
+		SpawnedRoom = World->SpawnActor<ADungeonRoom>(SpawnableClass, SpawnInfo.RoomLocation, FRotator());
 	}
 
+	// set before any door is added, so that reused rooms pick the same meshes as freshly spawned ones
+	SpawnedRoom->SetRandomStream(SpawnInfo.RandomStream);
+
 	return SpawnedRoom;
 }
 
+FDoorLayout ADungeonRoom::AddSpawnDoors(FDoorLayout Layout, const FSpawnInfo& SpawnInfo)
+{
+	if (SpawnInfo.DoorLayout.IsSet())
+	{
+		checkf(SpawnInfo.DoorLocations.Num() == 0, TEXT("Error: A spawn info must not have both door locations and a door layout"));
+		return SpawnInfo.DoorLayout.GetValue();
+	}
+
+	for (const FWallLocation& Location : SpawnInfo.DoorLocations)
+	{
+		checkf(!Layout.HasDoor(Location.WallDirection, Location.SegmentIndex), 
+			TEXT("Error: Attempted to add a door to a location that already has a door"));
+
+		Layout.AddDoor(Location.WallDirection, Location.SegmentIndex);
+	}
+
+	return Layout;
+}
+
 void ADungeonRoom::AddDoor(const FWallLocation& Location)
 {
+	DUNGEON_SCOPE_CYCLE_COUNTER(STAT_DungeonRoomAddDoor);
+
 	checkf(m_DoorMeshes.Num() > 0, TEXT("Error: Blueprint missing door meshes: %s"), *GetPathName());
 
 	checkf(IsValidWallLocation(Location), TEXT("Error: Attempted to add a door to an invalid location"));
 
 	checkf(!HasDoorAtLocation(Location), TEXT("Error: Attempted to add a door to a location that already has a door"));
 
-	SetStaticMesh(Location, GetRandomMesh(m_DoorMeshes));
+	checkf((GetBlockedSegments(Location.WallDirection) & (FDoorLayout::FWallMask{ 1 } << static_cast<int32>(Location.SegmentIndex))) == 0,
+		TEXT("Error: Attempted to add a door to a blocked segment: %s"), *GetPathName());
+
+	UStaticMesh* DoorMesh{ ChooseSegmentMesh(Location, true, m_RandomStream) };
+	SetStaticMesh(Location, DoorMesh);
+	CacheSegmentMesh(Location, true, DoorMesh);
+	m_DoorLayout.AddDoor(Location.WallDirection, Location.SegmentIndex);
+	INC_DWORD_STAT(STAT_DungeonDoorsChanged);
+
+	m_OnDoorChanged.Broadcast(this, Location, true);
 }
 
 void ADungeonRoom::RemoveDoor(const FWallLocation& Location)
 {
+	DUNGEON_SCOPE_CYCLE_COUNTER(STAT_DungeonRoomRemoveDoor);
+
 	checkf(m_WallMeshes.Num() > 0, TEXT("Error: Blueprint missing wall meshes: %s"), *GetPathName());
 
 	checkf(IsValidWallLocation(Location), TEXT("Error: Attempted to remove a door from an invalid location."));
 	
 	checkf(HasDoorAtLocation(Location), TEXT("Error: Attempted to remove a door from a location that did not have a door."))
 	
-	SetStaticMesh(Location, GetRandomMesh(m_WallMeshes));
+	UStaticMesh* WallMesh{ ChooseSegmentMesh(Location, false, m_RandomStream) };
+	SetStaticMesh(Location, WallMesh);
+	CacheSegmentMesh(Location, false, WallMesh);
+	m_DoorLayout.RemoveDoor(Location.WallDirection, Location.SegmentIndex);
+	INC_DWORD_STAT(STAT_DungeonDoorsChanged);
+
+	m_OnDoorChanged.Broadcast(this, Location, false);
 }
 
 bool ADungeonRoom::HasDoorAtLocation(const FWallLocation& Location) const
 {
 	checkf(IsValidWallLocation(Location), TEXT("Error: Attempted to check if there was a door at an invalid location"));
 
-	UStaticMesh* MeshAtLocation{ GetWall(Location.WallDirection)->GetSegment(Location.SegmentIndex)->GetStaticMesh() };
+	return m_DoorLayout.HasDoor(Location.WallDirection, Location.SegmentIndex);
+}
 
-	return m_DoorMeshes.Contains(MeshAtLocation);
+const FDoorLayout& ADungeonRoom::GetDoorLayout() const
+{
+	return m_DoorLayout;
 }
 
+int32 ADungeonRoom::GetNumDoors(const EDirection Direction) const
+{
+	return m_DoorLayout.GetNumDoors(Direction);
+}
+
+bool ADungeonRoom::HasFreeSegment(const EDirection Direction) const
+{
+	return GetFreeSegments(Direction) != 0;
+}
+
+int32 ADungeonRoom::GetFirstFreeSegment(const EDirection Direction) const
+{
+	const FDoorLayout::FWallMask FreeSegments{ GetFreeSegments(Direction) };
+	return FreeSegments != 0 ? static_cast<int32>(FMath::CountTrailingZeros64(FreeSegments)) : INDEX_NONE;
+}
+
+FDoorLayout::FWallMask ADungeonRoom::GetFreeSegments(const EDirection Direction) const
+{
+	const FDoorLayout::FWallMask Segments{ FDoorLayout::GetSegmentsMask(GetWall(Direction)->GetNumSegments()) };
+	return Segments & ~m_DoorLayout.GetWallMask(Direction) & ~GetBlockedSegments(Direction);
+}
+
+FDoorLayout::FWallMask ADungeonRoom::GetBlockedSegments(const EDirection Direction) const
+{
+	switch (Direction)
+	{
+		case EDirection::North: return static_cast<FDoorLayout::FWallMask>(m_BlockedNorthSegments);
+		case EDirection::South: return static_cast<FDoorLayout::FWallMask>(m_BlockedSouthSegments);
+		case EDirection::East:	return static_cast<FDoorLayout::FWallMask>(m_BlockedEastSegments);
+		case EDirection::West:  return static_cast<FDoorLayout::FWallMask>(m_BlockedWestSegments);
+
+		default:
+			checkf(false, TEXT("Error: Invalid argument given to GetBlockedSegments()"));
+			return 0;
+	}
+}
+
+FDoorLayout ADungeonRoom::GetDoorSlots() const
+{
+	FDoorLayout DoorSlots;
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		const FDoorLayout::FWallMask Segments{ FDoorLayout::GetSegmentsMask(GetWall(Direction)->GetNumSegments()) };
+		DoorSlots.SetWallMask(Direction, Segments & ~GetBlockedSegments(Direction));
+	}
+	return DoorSlots;
+}
+
+void ADungeonRoom::GetSegmentMeshes(TArray<UStaticMesh*>& OutMeshes) const
+{
+	for (UStaticMesh* Mesh : m_DoorMeshes)
+	{
+		if (Mesh)
+		{
+			OutMeshes.AddUnique(Mesh);
+		}
+	}
+	for (UStaticMesh* Mesh : m_WallMeshes)
+	{
+		if (Mesh)
+		{
+			OutMeshes.AddUnique(Mesh);
+		}
+	}
+}
+
+ADungeonRoom::FMemoryReport ADungeonRoom::GetMemoryReport() const
+{
+	FMemoryReport Report;
+
+	TArray<UStaticMeshComponent*> Components;
+	GetComponents(Components);
+	for (UStaticMeshComponent* Component : Components)
+	{
+		++Report.NumComponents;
+		Report.ComponentBytes += Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+		if (const FPrimitiveSceneProxy* Proxy{ Component->SceneProxy })
+		{
+			++Report.NumRenderProxies;
+			Report.RenderProxyBytes += Proxy->GetMemoryFootprint();
+		}
+	}
+
+	TArray<UStaticMesh*> Meshes;
+	GetSegmentMeshes(Meshes);
+	for (UStaticMesh* Mesh : Meshes)
+	{
+		Report.ReferencedAssetBytes += Mesh->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+	}
+
+	return Report;
+}
+
+void ADungeonRoom::InitializeDoorLayout()
+{
+	m_DoorLayout = FDoorLayout{ };
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		USegmentedWall* Wall{ GetWall(Direction) };
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < Wall->GetNumSegments(); ++SegmentIndex)
+		{
+			UStaticMesh* MeshAtLocation{ Wall->GetSegment(SegmentIndex)->GetStaticMesh() };
+			if (m_DoorMeshes.Contains(MeshAtLocation))
+			{
+				m_DoorLayout.AddDoor(Direction, SegmentIndex);
+			}
+		}
+	}
+
+	m_DefaultDoorLayout = m_DoorLayout;
+}
+
+void ADungeonRoom::Deactivate()
+{
+	// the previous owner of the room must not be notified of the doors being restored
+	m_OnDoorChanged.Clear();
+
+	ApplyDoorLayout(m_DefaultDoorLayout);
+
+	// the restored doors and walls may still show meshes picked during the last use, so every segment gets its blueprint mesh back
+	// before the cache is rebuilt from them, leaving a reused room exactly like a freshly spawned one
+	RestoreDefaultSegmentMeshes();
+	InitializeSegmentMeshCache();
+
+	DisableInstancedRendering();
+	RestoreSegments();
+
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+}
+
+void ADungeonRoom::Activate(const FVector& Location)
+{
+	SetActorLocation(Location);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+}
+
+void ADungeonRoom::ApplyDoorLayout(const FDoorLayout& Layout)
+{
+	DUNGEON_SCOPE_CYCLE_COUNTER(STAT_DungeonRoomApplyDoorLayout);
+
+	FDoorLayoutPlan Plan;
+	PlanDoorLayout(Layout, m_RandomStream, Plan);
+	ApplyDoorLayoutPlan(Plan);
+}
+
+void ADungeonRoom::PlanDoorLayout(const FDoorLayout& Layout, const FRandomStream& RandomStream, FDoorLayoutPlan& OutPlan) const
+{
+	OutPlan.Layout	     = Layout;
+	OutPlan.RandomStream = RandomStream;
+	OutPlan.SegmentChanges.Reset();
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		const FDoorLayout::FWallMask ValidSegments{ FDoorLayout::GetSegmentsMask(GetWall(Direction)->GetNumSegments()) };
+		checkf((Layout.GetWallMask(Direction) & ~ValidSegments) == 0, TEXT("Error: Attempted to apply a door layout with doors at invalid locations"));
+
+		FDoorLayout::FWallMask DoorsToAdd{ Layout.GetWallMask(Direction) & ~m_DoorLayout.GetWallMask(Direction) };
+		FDoorLayout::FWallMask DoorsToRemove{ m_DoorLayout.GetWallMask(Direction) & ~Layout.GetWallMask(Direction) };
+
+		checkf((DoorsToAdd & GetBlockedSegments(Direction)) == 0, TEXT("Error: Attempted to apply a door layout with doors on blocked segments: %s"), *GetPathName());
+
+		checkf(DoorsToAdd == 0 || m_DoorMeshes.Num() > 0, TEXT("Error: Blueprint missing door meshes: %s"), *GetPathName());
+		checkf(DoorsToRemove == 0 || m_WallMeshes.Num() > 0, TEXT("Error: Blueprint missing wall meshes: %s"), *GetPathName());
+
+		USegmentedWall* Wall{ GetWall(Direction) };
+		const int32 FirstSegmentSlot{ GetSegmentSlot({ Direction, 0 }) };
+
+		while (DoorsToAdd != 0)
+		{
+			const int32 SegmentIndex{ static_cast<int32>(FMath::CountTrailingZeros64(DoorsToAdd)) };
+			const int32 SegmentSlot{ FirstSegmentSlot + SegmentIndex };
+			OutPlan.SegmentChanges.Add({ Wall->GetSegment(SegmentIndex), SegmentSlot, ChooseSegmentMesh(SegmentSlot, true, OutPlan.RandomStream), true });
+			DoorsToAdd &= DoorsToAdd - 1;
+		}
+
+		while (DoorsToRemove != 0)
+		{
+			const int32 SegmentIndex{ static_cast<int32>(FMath::CountTrailingZeros64(DoorsToRemove)) };
+			const int32 SegmentSlot{ FirstSegmentSlot + SegmentIndex };
+			OutPlan.SegmentChanges.Add({ Wall->GetSegment(SegmentIndex), SegmentSlot, ChooseSegmentMesh(SegmentSlot, false, OutPlan.RandomStream), false });
+			DoorsToRemove &= DoorsToRemove - 1;
+		}
+	}
+}
+
+void ADungeonRoom::ApplyDoorLayoutPlan(const FDoorLayoutPlan& Plan)
+{
+	const FDoorLayout CurrentLayout{ m_DoorLayout };
+	const FDoorLayout& Layout{ Plan.Layout };
+
+	INC_DWORD_STAT_BY(STAT_DungeonDoorsChanged, Plan.SegmentChanges.Num());
+
+	for (const FSegmentChange& SegmentChange : Plan.SegmentChanges)
+	{
+		SetStaticMesh(SegmentChange.Segment, SegmentChange.SegmentSlot, SegmentChange.Mesh);
+		CacheSegmentMesh(SegmentChange.SegmentSlot, SegmentChange.bIsDoor, SegmentChange.Mesh);
+	}
+
+	m_RandomStream = Plan.RandomStream;
+	m_DoorLayout   = Layout;
+
+	// listeners are only notified once the whole layout is in place, so they never observe a partially applied layout
+	if (m_OnDoorChanged.IsBound())
+	{
+		for (const EDirection Direction : FDoorLayout::WallDirections)
+		{
+			FDoorLayout::FWallMask ChangedDoors{ CurrentLayout.GetWallMask(Direction) ^ Layout.GetWallMask(Direction) };
+			while (ChangedDoors != 0)
+			{
+				const int32 SegmentIndex{ static_cast<int32>(FMath::CountTrailingZeros64(ChangedDoors)) };
+				m_OnDoorChanged.Broadcast(this, { Direction, SegmentIndex }, Layout.HasDoor(Direction, SegmentIndex));
+				ChangedDoors &= ChangedDoors - 1;
+			}
+		}
+	}
+}
+
+ADungeonRoom::FOnDoorChanged& ADungeonRoom::OnDoorChanged()
+{
+	return m_OnDoorChanged;
+}
+
+FNumberOfTiles ADungeonRoom::GetWidth() const
+{
+	return m_Width;
+}
+
+FNumberOfTiles ADungeonRoom::GetLength() const
+{
+	return m_Length;
+}
 
 USegmentedWall* ADungeonRoom::CreateWall(const FName Name)
 {
@@ -108,6 +766,43 @@ void ADungeonRoom::PostActorCreated()
 	checkf(m_WallMeshes.Num() > 0, TEXT("Error: Blueprint missing wall meshes: %s"), *GetPathName());
 }
 
+void ADungeonRoom::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// the walls only populate their segments in game worlds
+	const UWorld* World{ GetWorld() };
+	if (World && World->IsGameWorld())
+	{
+		InitializeDoorLayout();
+		InitializeDefaultSegmentMeshes();
+		InitializeSegmentMeshCache();
+
+		if (m_bUseDualSegments)
+		{
+			CreateCompanionSegments();
+		}
+	}
+}
+
+void ADungeonRoom::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (IsValid(m_SegmentRenderer))
+	{
+		for (const EDirection Direction : FDoorLayout::WallDirections)
+		{
+			USegmentedWall* Wall{ GetWall(Direction) };
+			for (int32 SegmentIndex{ 0 }; SegmentIndex < Wall->GetNumSegments(); ++SegmentIndex)
+			{
+				m_SegmentRenderer->RemoveSegment(Wall->GetSegment(SegmentIndex));
+			}
+		}
+	}
+	m_SegmentRenderer = nullptr;
+
+	Super::EndPlay(EndPlayReason);
+}
+
 
 
 
@@ -0,0 +1,40 @@
+#include "DungeonRoomAssetTags.h"
+
+#include "DungeonRoom.h"
+
+float FDungeonRoomAssetTags::GetSelectionWeight(const FAssetData& Asset)
+{
+	float SelectionWeight{ GetDefault<ADungeonRoom>()->m_SelectionWeight };
+	Asset.GetTagValue(GET_MEMBER_NAME_CHECKED(ADungeonRoom, m_SelectionWeight), SelectionWeight);
+	return SelectionWeight;
+}
+
+FDoorLayout::FWallMask FDungeonRoomAssetTags::GetBlockedSegments(const FAssetData& Asset, const EDirection Wall)
+{
+	const ADungeonRoom* DefaultRoom{ GetDefault<ADungeonRoom>() };
+
+	int64 BlockedSegments{ DefaultRoom->GetBlockedSegments(Wall) };
+	switch (Wall)
+	{
+		case EDirection::North: Asset.GetTagValue(GET_MEMBER_NAME_CHECKED(ADungeonRoom, m_BlockedNorthSegments), BlockedSegments); break;
+		case EDirection::South: Asset.GetTagValue(GET_MEMBER_NAME_CHECKED(ADungeonRoom, m_BlockedSouthSegments), BlockedSegments); break;
+		case EDirection::East:	Asset.GetTagValue(GET_MEMBER_NAME_CHECKED(ADungeonRoom, m_BlockedEastSegments), BlockedSegments); break;
+		case EDirection::West:  Asset.GetTagValue(GET_MEMBER_NAME_CHECKED(ADungeonRoom, m_BlockedWestSegments), BlockedSegments); break;
+
+		default:
+			checkf(false, TEXT("Error: Invalid argument given to GetBlockedSegments()"));
+			break;
+	}
+	return static_cast<FDoorLayout::FWallMask>(BlockedSegments);
+}
+
+FDoorLayout FDungeonRoomAssetTags::GetDoorSlots(const FAssetData& Asset, int32 Width, int32 Length)
+{
+	FDoorLayout DoorSlots;
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		const int32 NumSegments{ Direction == EDirection::North || Direction == EDirection::South ? Width : Length };
+		DoorSlots.SetWallMask(Direction, FDoorLayout::GetSegmentsMask(NumSegments) & ~GetBlockedSegments(Asset, Direction));
+	}
+	return DoorSlots;
+}
@@ -0,0 +1,166 @@
+#include "DungeonRoomAsyncSpawner.h"
+
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+
+FDungeonRoomAsyncSpawner::FDungeonRoomAsyncSpawner(UWorld* World, double FrameBudgetSeconds)
+	: m_World{ World }
+	, m_FrameBudgetSeconds{ FrameBudgetSeconds }
+{
+	checkf(World, TEXT("Error: Attempted to create an async room spawner without a world"));
+}
+
+FDungeonRoomAsyncSpawner::~FDungeonRoomAsyncSpawner()
+{
+	CancelAll();
+}
+
+TFuture<TArray<ADungeonRoom*>> FDungeonRoomAsyncSpawner::SpawnRooms(TArray<FAsyncSpawnInfo> SpawnInfos, FOnBatchSpawned OnBatchSpawned)
+{
+	TUniquePtr<FSpawnBatch> Batch{ MakeUnique<FSpawnBatch>() };
+	Batch->SpawnInfos     = MoveTemp(SpawnInfos);
+	Batch->OnBatchSpawned = MoveTemp(OnBatchSpawned);
+	Batch->SpawnedRooms.Reserve(Batch->SpawnInfos.Num());
+
+	TFuture<TArray<ADungeonRoom*>> Future{ Batch->Promise.GetFuture() };
+
+	// rooms frequently share assets, so each asset is only requested once per batch
+	TArray<FSoftObjectPath> AssetsToLoad;
+	for (const FAsyncSpawnInfo& SpawnInfo : Batch->SpawnInfos)
+	{
+		AssetsToLoad.AddUnique(SpawnInfo.AssetPath);
+	}
+
+	if (AssetsToLoad.Num() > 0)
+	{
+		Batch->LoadHandle = m_StreamableManager.RequestAsyncLoad(MoveTemp(AssetsToLoad));
+	}
+
+	m_Batches.Add(MoveTemp(Batch));
+	return Future;
+}
+
+void FDungeonRoomAsyncSpawner::SetFrameBudget(double FrameBudgetSeconds)
+{
+	m_FrameBudgetSeconds = FrameBudgetSeconds;
+}
+
+bool FDungeonRoomAsyncSpawner::IsIdle() const
+{
+	return m_Batches.Num() == 0;
+}
+
+void FDungeonRoomAsyncSpawner::CancelAll()
+{
+	for (TUniquePtr<FSpawnBatch>& Batch : m_Batches)
+	{
+		if (Batch->LoadHandle.IsValid())
+		{
+			Batch->LoadHandle->CancelHandle();
+		}
+		CompleteBatch(*Batch);
+	}
+	m_Batches.Empty();
+}
+
+void FDungeonRoomAsyncSpawner::Tick(float DeltaTime)
+{
+	if (!m_World.IsValid())
+	{
+		CancelAll();
+		return;
+	}
+
+	const double StartTime{ FPlatformTime::Seconds() };
+	bool bHasSpawnedRoom{ false };
+
+	while (m_Batches.Num() > 0)
+	{
+		FSpawnBatch& Batch{ *m_Batches[0] };
+
+		// batches are completed in order, so a batch that is still loading holds back the ones behind it
+		if (Batch.LoadHandle.IsValid() && Batch.LoadHandle->IsLoadingInProgress())
+		{
+			return;
+		}
+
+		while (Batch.SpawnedRooms.Num() < Batch.SpawnInfos.Num())
+		{
+			if (bHasSpawnedRoom && FPlatformTime::Seconds() - StartTime >= m_FrameBudgetSeconds)
+			{
+				return;
+			}
+
+			SpawnNextRoom(Batch);
+			bHasSpawnedRoom = true;
+		}
+
+		CompleteBatch(Batch);
+		m_Batches.RemoveAt(0);
+	}
+}
+
+bool FDungeonRoomAsyncSpawner::IsTickable() const
+{
+	return m_Batches.Num() > 0;
+}
+
+ETickableTickType FDungeonRoomAsyncSpawner::GetTickableTickType() const
+{
+	return ETickableTickType::Conditional;
+}
+
+UWorld* FDungeonRoomAsyncSpawner::GetTickableGameObjectWorld() const
+{
+	return m_World.Get();
+}
+
+TStatId FDungeonRoomAsyncSpawner::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FDungeonRoomAsyncSpawner, STATGROUP_Tickables);
+}
+
+void FDungeonRoomAsyncSpawner::SpawnNextRoom(FSpawnBatch& Batch)
+{
+	const FAsyncSpawnInfo& AsyncSpawnInfo{ Batch.SpawnInfos[Batch.SpawnedRooms.Num()] };
+
+	ADungeonRoom* SpawnedRoom{ nullptr };
+
+	UObject* LoadedAsset{ AsyncSpawnInfo.AssetPath.ResolveObject() };
+	if (LoadedAsset)
+	{
+		ADungeonRoom::FSpawnInfo SpawnInfo;
+		SpawnInfo.LoadedAsset   = LoadedAsset;
+		SpawnInfo.RoomLocation  = AsyncSpawnInfo.RoomLocation;
+		SpawnInfo.DoorLocations = AsyncSpawnInfo.DoorLocations;
+		SpawnInfo.RandomStream  = AsyncSpawnInfo.RandomStream;
+
+		SpawnedRoom = ADungeonRoom::Spawn(SpawnInfo, m_World.Get());
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Failed to load room asset: %s"), *AsyncSpawnInfo.AssetPath.ToString());
+	}
+
+	Batch.SpawnedRooms.Add(SpawnedRoom);
+
+	if (AsyncSpawnInfo.OnSpawned)
+	{
+		AsyncSpawnInfo.OnSpawned(SpawnedRoom);
+	}
+}
+
+void FDungeonRoomAsyncSpawner::CompleteBatch(FSpawnBatch& Batch)
+{
+	if (Batch.LoadHandle.IsValid())
+	{
+		Batch.LoadHandle->ReleaseHandle();
+	}
+
+	if (Batch.OnBatchSpawned)
+	{
+		Batch.OnBatchSpawned(Batch.SpawnedRooms);
+	}
+
+	Batch.Promise.SetValue(MoveTemp(Batch.SpawnedRooms));
+}
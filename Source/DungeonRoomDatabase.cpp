@@ -6,54 +6,311 @@
 #include "Dungeon/Structs/DungeonRoomSpecs.h"
 #include "System/AssetSearcher.h"			
 #include "System/DungeonRoomAssetAnalyzer.h" 
-#include "Algo/ForEach.h"
+#include "DungeonRoomAssetTags.h"
+#include "Dungeon/DungeonStats.h"
+#include "Async/ParallelFor.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "System/BaseBlueprintAssetAnalyzer.h"
+#include "Engine/StaticMesh.h"
+
+#if WITH_EDITOR
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#endif
+
+namespace
+{
+	constexpr uint32 SnapshotMagic{ 0x44524442 };	// identifies a room database snapshot ("DRDB")
+
+	constexpr int32 SnapshotVersion{ 5 };		// incremented whenever the snapshot layout changes
+
+	constexpr int32 MinAssetsForParallelIngest{ 256 }; // below this, extracting tags on worker threads costs more than it saves
+
+	/** Reads or writes the given specs, depending on the direction of the archive. */
+	void SerializeRoomSpecs(FArchive& Archive, FDungeonRoomSpecs& Specs)
+	{
+		uint8 Theme{ static_cast<uint8>(Specs.Theme) };
+		int32 Width{ Specs.Dimensions.Width };
+		int32 Length{ Specs.Dimensions.Length };
+
+		Archive << Theme << Width << Length;
+
+		Specs.Theme             = static_cast<EDungeonTheme>(Theme);
+		Specs.Dimensions.Width  = Width;
+		Specs.Dimensions.Length = Length;
+	}
+
+	/**
+	 * Returns the path of the class generated from the blueprint at the given path, which is what cooked builds resolve room assets to.
+	 * Paths that already name a generated class are returned unchanged.
+	 */
+	FSoftObjectPath GetGeneratedClassPath(const FSoftObjectPath& Path)
+	{
+		const FString AssetName{ Path.GetAssetName() };
+		if (AssetName.EndsWith(TEXT("_C")))
+		{
+			return Path;
+		}
+
+		return FSoftObjectPath{ FString::Printf(TEXT("%s.%s_C"), *Path.GetLongPackageName(), *AssetName) };
+	}
+
+	/** Orders paths by their text, so every process holding the same assets orders them the same way. */
+	bool PathLess(const FSoftObjectPath& A, const FSoftObjectPath& B)
+	{
+		return A.LexicalLess(B);
+	}
+
+	/** Orders dimensions by their first component, then their second. */
+	bool LexicographicLess(const FIntPoint& A, const FIntPoint& B)
+	{
+		return A.X < B.X || (A.X == B.X && A.Y < B.Y);
+	}
+
+	/** Returns the index of the first entry greater than the given dimensions. */
+	int32 UpperBound(const TArray<FIntPoint>& SortedDimensions, const FIntPoint& Dimensions)
+	{
+		return Algo::UpperBound(SortedDimensions, Dimensions, &LexicographicLess);
+	}
+}
 
 FDungeonRoomDatabase::FDungeonRoomDatabase(FName PathToAssets)
+	: m_PathToAssets{ PathToAssets }
+{
+	// the snapshot cannot be trusted while assets can still be edited, so only cooked builds use it
+	if (!FPlatformProperties::RequiresCookedData() || !LoadSnapshot(GetSnapshotFilePath(PathToAssets)))
+	{
+		InitializeDatabase(PathToAssets);
+	}
+
+	BuildDerivedData();
+
+#if WITH_EDITOR
+	if (GIsEditor && !IsRunningCommandlet())
+	{
+		SubscribeToAssetRegistry();
+	}
+#endif
+}
+
+FDungeonRoomDatabase::~FDungeonRoomDatabase()
+{
+#if WITH_EDITOR
+	UnsubscribeFromAssetRegistry();
+#endif
+}
+
+FString FDungeonRoomDatabase::GetSnapshotFilePath(FName PathToAssets)
+{
+	const FString FileName{ FPaths::MakeValidFileName(PathToAssets.ToString(), TEXT('_')) + TEXT(".bin") };
+
+	// staged into the pak through DirectoriesToAlwaysStageAsUFS in Config/DefaultGame.ini, where FFileHelper can still read it
+	return FPaths::ProjectContentDir() / TEXT("DungeonRoomDatabase") / FileName;
+}
+
+bool FDungeonRoomDatabase::SaveSnapshot(const FString& FilePath) const
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer{ Bytes };
+
+	uint32 Magic{ SnapshotMagic };
+	int32 Version{ SnapshotVersion };
+	Writer << Magic << Version;
+
+	int32 NumRecords{ m_RecordsByPath.Num() };
+	Writer << NumRecords;
+
+	// the snapshot is written from the editor but only loaded by cooked builds, where rooms are found by their generated class
+	TArray<FRoomAssetRecord> Records;
+	m_RecordsByPath.GenerateValueArray(Records);
+	for (FRoomAssetRecord& Record : Records)
+	{
+		Record.Path = GetGeneratedClassPath(Record.Path);
+	}
+
+	// written in order of path rather than map order, so identical databases give identical snapshots
+	Records.Sort([](const FRoomAssetRecord& A, const FRoomAssetRecord& B) { return PathLess(A.Path, B.Path); });
+	for (FRoomAssetRecord& Record : Records)
+	{
+		SerializeRecord(Writer, Record);
+	}
+
+	return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+}
+
+bool FDungeonRoomDatabase::LoadSnapshot(const FString& FilePath)
 {
-	InitializeDatabase(PathToAssets);
+	DUNGEON_SCOPE_CYCLE_COUNTER(STAT_DungeonDatabaseLoadSnapshot);
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath, FILEREAD_Silent))
+	{
+		return false;
+	}
+	INC_DWORD_STAT_BY(STAT_DungeonDatabaseSnapshotBytesRead, Bytes.Num());
+
+	FMemoryReader Reader{ Bytes };
+
+	uint32 Magic{ 0 };
+	int32 Version{ 0 };
+	Reader << Magic << Version;
+
+	if (Magic != SnapshotMagic || Version != SnapshotVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ignoring room database snapshot with an unexpected version: %s"), *FilePath);
+		return false;
+	}
+
+	int32 NumRecords{ 0 };
+	Reader << NumRecords;
+
+	// the count is bounded by the bytes left, so a corrupt count cannot reserve more records than the file could hold
+	constexpr int64 MinRecordBytes{ sizeof(int32) + sizeof(uint8) + sizeof(int32) * 2 + sizeof(float) + sizeof(FDoorLayout::FWallMask) * FDoorLayout::NumWalls + sizeof(int64) };
+	if (Reader.IsError() || NumRecords <= 0 || NumRecords > (Reader.TotalSize() - Reader.Tell()) / MinRecordBytes)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ignoring malformed room database snapshot: %s"), *FilePath);
+		return false;
+	}
+
+	TArray<FRoomAssetRecord> Records;
+	Records.Reserve(NumRecords);
+	for (int32 RecordIndex{ 0 }; RecordIndex < NumRecords && !Reader.IsError(); ++RecordIndex)
+	{
+		SerializeRecord(Reader, Records.AddDefaulted_GetRef());
+	}
+
+	if (Reader.IsError() || Records.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ignoring malformed room database snapshot: %s"), *FilePath);
+		return false;
+	}
+
+	AddRecordsToDatabase(MoveTemp(Records));
+	return true;
+}
+
+void FDungeonRoomDatabase::SerializeRecord(FArchive& Archive, FRoomAssetRecord& Record)
+{
+	FString PathString{ Record.Path.ToString() };
+	Archive << PathString;
+	Record.Path = FSoftObjectPath{ PathString };
+
+	SerializeRoomSpecs(Archive, Record.Specs);
+
+	Archive << Record.Weight;
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		FDoorLayout::FWallMask DoorSlots{ Record.DoorSlots.GetWallMask(Direction) };
+		Archive << DoorSlots;
+		Record.DoorSlots.SetWallMask(Direction, DoorSlots);
+	}
+
+	Archive << Record.EstimatedSize;
 }
 
 void FDungeonRoomDatabase::InitializeDatabase(FName PathToAssets)
 {
+	DUNGEON_SCOPE_CYCLE_COUNTER(STAT_DungeonDatabaseInitialize);
+
 	TArray<FAssetData> RoomAssets { FAssetSearcher::FindDerivedBlueprintAssetsInPath(PathToAssets, ADungeonRoom::StaticClass()) };
 	checkf(RoomAssets.Num() > 0, TEXT("Error: No DungeonRoomAssets were found in the designated path: %s"), *PathToAssets.ToString());
 
-	Algo::ForEach(RoomAssets, [this](const FAssetData& Asset) { 
-		this->AddAssetToDatabase(Asset);
-	});
+	AddAssetsToDatabase(RoomAssets);
 }
 
-void FDungeonRoomDatabase::AddAssetToDatabase(const FAssetData& Asset)
+FDungeonRoomDatabase::FRoomAssetRecord FDungeonRoomDatabase::ExtractRecord(const FAssetData& Asset)
 {
-	UpdateAssetPathsMap(Asset);
-	
-	UpdateMaxWidthAndLengthMaps(Asset);
+	const FDungeonRoomSpecs Specs{ FDungeonRoomAssetAnalyzer::GetRoomSpecs(Asset) };
+
+	// the size is only known once the asset is loaded, so it is left to MeasureAssetSizes
+	return FRoomAssetRecord{ 
+		FDungeonRoomAssetAnalyzer::GetSoftObjectPath(Asset), 
+		Specs, 
+		FDungeonRoomAssetTags::GetSelectionWeight(Asset),
+		FDungeonRoomAssetTags::GetDoorSlots(Asset, Specs.Dimensions.Width, Specs.Dimensions.Length)
+	};
 }
 
-void FDungeonRoomDatabase::UpdateAssetPathsMap(const FAssetData& Asset)
+void FDungeonRoomDatabase::AddAssetsToDatabase(TConstArrayView<FAssetData> Assets)
 {
-	FSoftObjectPath PathToAsset{ FDungeonRoomAssetAnalyzer::GetSoftObjectPath(Asset) };
+	TArray<FRoomAssetRecord> Records;
+	Records.SetNum(Assets.Num());
 
-	FDungeonRoomSpecs RoomSpecs{ FDungeonRoomAssetAnalyzer::GetRoomSpecs(Asset) };
+	// reading tags only touches the immutable asset data, so every asset can be processed independently
+	ParallelFor(Assets.Num(), [&Records, &Assets](int32 AssetIndex) {
+		Records[AssetIndex] = ExtractRecord(Assets[AssetIndex]);
+	}, Assets.Num() < MinAssetsForParallelIngest ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
 
-	TArray<FSoftObjectPath>& AssetPaths{ m_PathsByRoomSpecs.FindOrAdd(RoomSpecs) };
-	AssetPaths.Add(PathToAsset);
+	AddRecordsToDatabase(MoveTemp(Records));
 }
 
-void FDungeonRoomDatabase::UpdateMaxWidthAndLengthMaps(const FAssetData& Asset)
+void FDungeonRoomDatabase::AddRecordsToDatabase(TArray<FRoomAssetRecord> Records)
 {
-	FDungeonRoomSpecs RoomSpecs{ FDungeonRoomAssetAnalyzer::GetRoomSpecs(Asset) };
-	
-	FNumberOfTiles& MaxWidth{ m_MaxWidthByTheme.FindOrAdd(RoomSpecs.Theme) };
-	if (RoomSpecs.Dimensions.Width > MaxWidth)
+	INC_DWORD_STAT_BY(STAT_DungeonAssetsIndexed, Records.Num());
+
+	// sorted up front, so a scan and a snapshot fill every bucket in the same order and each record is appended to its bucket
+	Records.Sort([](const FRoomAssetRecord& A, const FRoomAssetRecord& B) { return PathLess(A.Path, B.Path); });
+
+	TMap<FDungeonRoomSpecs, int32> NumAssetsBySpecs;
+	NumAssetsBySpecs.Reserve(Records.Num());
+	for (const FRoomAssetRecord& Record : Records)
+	{
+		++NumAssetsBySpecs.FindOrAdd(Record.Specs);
+	}
+
+	m_RecordsByPath.Reserve(m_RecordsByPath.Num() + Records.Num());
+	m_PathsByRoomSpecs.Reserve(m_PathsByRoomSpecs.Num() + NumAssetsBySpecs.Num());
+	for (const TPair<FDungeonRoomSpecs, int32>& Pair : NumAssetsBySpecs)
+	{
+		TArray<FSoftObjectPath>& AssetPaths{ m_PathsByRoomSpecs.FindOrAdd(Pair.Key) };
+		AssetPaths.Reserve(AssetPaths.Num() + Pair.Value);
+	}
+
+	for (const FRoomAssetRecord& Record : Records)
+	{
+		AddRecordToDatabase(Record);
+	}
+}
+
+void FDungeonRoomDatabase::AddAssetToDatabase(const FAssetData& Asset)
+{
+	AddRecordToDatabase(ExtractRecord(Asset));
+}
+
+void FDungeonRoomDatabase::AddRecordToDatabase(const FRoomAssetRecord& Record)
+{
+	// buckets are kept sorted by path, so the alias tables built over them, and the rooms sampled with a given seed, do not depend on ingestion order
+	TArray<FSoftObjectPath>& AssetPaths{ m_PathsByRoomSpecs.FindOrAdd(Record.Specs) };
+	AssetPaths.Insert(Record.Path, Algo::LowerBound(AssetPaths, Record.Path, &PathLess));
+
+	m_RecordsByPath.Add(Record.Path, Record);
+
+	FNumberOfTiles& MaxWidth{ m_MaxWidthByTheme.FindOrAdd(Record.Specs.Theme) };
+	if (Record.Specs.Dimensions.Width > MaxWidth)
 	{
-		MaxWidth = RoomSpecs.Dimensions.Width;
+		MaxWidth = Record.Specs.Dimensions.Width;
 	}
 
-	FNumberOfTiles& MaxLength{ m_MaxLengthByTheme.FindOrAdd(RoomSpecs.Theme) };
-	if (RoomSpecs.Dimensions.Length > MaxLength)
+	FNumberOfTiles& MaxLength{ m_MaxLengthByTheme.FindOrAdd(Record.Specs.Theme) };
+	if (Record.Specs.Dimensions.Length > MaxLength)
 	{
-		MaxLength = RoomSpecs.Dimensions.Length;
+		MaxLength = Record.Specs.Dimensions.Length;
+	}
+}
+
+void FDungeonRoomDatabase::GetRoomSpecs(EDungeonTheme Theme, TArray<FDungeonRoomSpecs>& OutSpecs) const
+{
+	for (const TPair<FDungeonRoomSpecs, TArray<FSoftObjectPath>>& Pair : m_PathsByRoomSpecs)
+	{
+		if (Pair.Key.Theme == Theme)
+		{
+			OutSpecs.Add(Pair.Key);
+		}
 	}
 }
 
@@ -64,14 +321,107 @@ const TArray<FSoftObjectPath>& FDungeonRoomDatabase::GetAssetPaths(const FDungeo
 
 FNumberOfTiles FDungeonRoomDatabase::GetMaxWidth(EDungeonTheme Theme) const
 {
+	RefreshStaleMaxima();
 	return m_MaxWidthByTheme.FindChecked(Theme);
 }
 
 FNumberOfTiles FDungeonRoomDatabase::GetMaxLength(EDungeonTheme Theme) const
 {
+	RefreshStaleMaxima();
 	return m_MaxLengthByTheme.FindChecked(Theme);
 }
 
+const FSoftObjectPath& FDungeonRoomDatabase::SampleAssetPath(const FDungeonRoomSpecs& RoomSpecs, const FRandomStream& RandomStream) const
+{
+	RefreshStaleDerivedData();
+
+	const int32 PathIndex{ m_AliasTablesBySpecs.FindChecked(RoomSpecs).Sample(RandomStream) };
+
+	return m_PathsByRoomSpecs.FindChecked(RoomSpecs)[PathIndex];
+}
+
+const FSoftObjectPath* FDungeonRoomDatabase::SampleAssetPathAllowingDoors(const FDungeonRoomSpecs& RoomSpecs, const FDoorLayout& Doors, const FRandomStream& RandomStream) const
+{
+	const TArray<FSoftObjectPath>* AssetPaths{ m_PathsByRoomSpecs.Find(RoomSpecs) };
+	if (!AssetPaths)
+	{
+		return nullptr;
+	}
+
+	TArray<float, TInlineAllocator<32>> Weights;
+	Weights.Reserve(AssetPaths->Num());
+	float TotalWeight{ 0.0f };
+	int32 NumAllowing{ 0 };
+	for (const FSoftObjectPath& Path : *AssetPaths)
+	{
+		const FRoomAssetRecord& Record{ m_RecordsByPath.FindChecked(Path) };
+		const bool bAllowsDoors{ Record.DoorSlots.Contains(Doors) };
+		Weights.Add(bAllowsDoors ? Record.Weight : 0.0f);
+		TotalWeight += Weights.Last();
+		NumAllowing += bAllowsDoors ? 1 : 0;
+	}
+
+	if (NumAllowing == AssetPaths->Num())
+	{
+		return &SampleAssetPath(RoomSpecs, RandomStream);
+	}
+
+	if (TotalWeight <= 0.0f)
+	{
+		return nullptr;
+	}
+
+	// few assets share a set of specs, so walking the filtered weights is cheaper than building an alias table for every set of doors
+	float Remaining{ RandomStream.GetFraction() * TotalWeight };
+	int32 LastAllowingIndex{ INDEX_NONE };
+	for (int32 PathIndex{ 0 }; PathIndex < Weights.Num(); ++PathIndex)
+	{
+		if (Weights[PathIndex] <= 0.0f)
+		{
+			continue;
+		}
+
+		if (Remaining < Weights[PathIndex])
+		{
+			return &(*AssetPaths)[PathIndex];
+		}
+		Remaining -= Weights[PathIndex];
+		LastAllowingIndex = PathIndex;
+	}
+
+	// rounding can leave a sliver of the total past the last weight, which belongs to the last allowing asset
+	return &(*AssetPaths)[LastAllowingIndex];
+}
+
+const FDungeonRoomSpecs* FDungeonRoomDatabase::FindRoomSpecs(const FSoftObjectPath& Path) const
+{
+	const FRoomAssetRecord* Record{ m_RecordsByPath.Find(Path) };
+	return Record ? &Record->Specs : nullptr;
+}
+
+const FDoorLayout* FDungeonRoomDatabase::FindDoorSlots(const FSoftObjectPath& Path) const
+{
+	const FRoomAssetRecord* Record{ m_RecordsByPath.Find(Path) };
+	return Record ? &Record->DoorSlots : nullptr;
+}
+
+void FDungeonRoomDatabase::GetAssetPathsAllowingDoors(const FDungeonRoomSpecs& RoomSpecs, const FDoorLayout& Doors, TArray<FSoftObjectPath>& OutPaths) const
+{
+	const TArray<FSoftObjectPath>* AssetPaths{ m_PathsByRoomSpecs.Find(RoomSpecs) };
+	if (!AssetPaths)
+	{
+		return;
+	}
+
+	for (const FSoftObjectPath& Path : *AssetPaths)
+	{
+		if (m_RecordsByPath.FindChecked(Path).DoorSlots.Contains(Doors))
+		{
+			OutPaths.Add(Path);
+		}
+	}
+}
+
 bool FDungeonRoomDatabase::DoesAssetExistWithSpecs(const FDungeonRoomSpecs& Specs) const
 {
 	checkf(Specs.Dimensions.Width > 0 && Specs.Dimensions.Length > 0, 
@@ -80,5 +430,493 @@ bool FDungeonRoomDatabase::DoesAssetExistWithSpecs(const FDungeonRoomSpecs& Spec
 	return m_PathsByRoomSpecs.Contains(Specs);
 }
 
+void FDungeonRoomDatabase::RemovePathFromDatabase(const FSoftObjectPath& Path)
+{
+	FRoomAssetRecord Record;
+	if (!m_RecordsByPath.RemoveAndCopyValue(Path, Record))
+	{
+		return;
+	}
+	const FDungeonRoomSpecs& Specs{ Record.Specs };
+
+	TArray<FSoftObjectPath>& AssetPaths{ m_PathsByRoomSpecs.FindChecked(Specs) };
+	AssetPaths.RemoveSingle(Path);
+	if (AssetPaths.Num() == 0)
+	{
+		m_PathsByRoomSpecs.Remove(Specs);
+	}
+
+	// the maxima can only shrink if the removed room defined one of them; recomputing them is deferred until they are queried
+	const bool bDefinedMaxWidth{ Specs.Dimensions.Width >= m_MaxWidthByTheme.FindChecked(Specs.Theme) };
+	const bool bDefinedMaxLength{ Specs.Dimensions.Length >= m_MaxLengthByTheme.FindChecked(Specs.Theme) };
+	if (bDefinedMaxWidth || bDefinedMaxLength)
+	{
+		m_ThemesWithStaleMaxima.Add(Specs.Theme);
+		m_bHasStaleMaxima = true;
+	}
+
+	m_bIsDerivedDataStale = true;
+}
+
+void FDungeonRoomDatabase::RefreshStaleMaxima() const
+{
+	// the flag is checked again under the lock, so only one of several concurrent readers recomputes the maxima
+	if (!m_bHasStaleMaxima.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	FScopeLock Lock{ &m_DerivedDataLock };
+	if (!m_bHasStaleMaxima.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	for (const EDungeonTheme Theme : m_ThemesWithStaleMaxima)
+	{
+		m_MaxWidthByTheme.Remove(Theme);
+		m_MaxLengthByTheme.Remove(Theme);
+	}
+
+	// only the distinct specs are visited, rather than every asset
+	for (const TPair<FDungeonRoomSpecs, TArray<FSoftObjectPath>>& Pair : m_PathsByRoomSpecs)
+	{
+		const FDungeonRoomSpecs& Specs{ Pair.Key };
+		if (!m_ThemesWithStaleMaxima.Contains(Specs.Theme))
+		{
+			continue;
+		}
+
+		FNumberOfTiles& MaxWidth{ m_MaxWidthByTheme.FindOrAdd(Specs.Theme) };
+		if (Specs.Dimensions.Width > MaxWidth)
+		{
+			MaxWidth = Specs.Dimensions.Width;
+		}
+
+		FNumberOfTiles& MaxLength{ m_MaxLengthByTheme.FindOrAdd(Specs.Theme) };
+		if (Specs.Dimensions.Length > MaxLength)
+		{
+			MaxLength = Specs.Dimensions.Length;
+		}
+	}
+
+	m_ThemesWithStaleMaxima.Empty();
+	m_bHasStaleMaxima.store(false, std::memory_order_release);
+}
+
+void FDungeonRoomDatabase::RefreshStaleDerivedData() const
+{
+	if (!m_bIsDerivedDataStale.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	FScopeLock Lock{ &m_DerivedDataLock };
+	if (m_bIsDerivedDataStale.load(std::memory_order_relaxed))
+	{
+		BuildDerivedData();
+	}
+}
+
+void FDungeonRoomDatabase::PrepareForConcurrentReads() const
+{
+	RefreshStaleMaxima();
+	RefreshStaleDerivedData();
+}
+
+#if WITH_EDITOR
+void FDungeonRoomDatabase::SubscribeToAssetRegistry()
+{
+	IAssetRegistry& AssetRegistry{ FAssetRegistryModule::GetRegistry() };
+
+	m_OnAssetAddedHandle   = AssetRegistry.OnAssetAdded().AddRaw(this, &FDungeonRoomDatabase::OnAssetAdded);
+	m_OnAssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FDungeonRoomDatabase::OnAssetRemoved);
+	m_OnAssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FDungeonRoomDatabase::OnAssetRenamed);
+	m_OnAssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FDungeonRoomDatabase::OnAssetUpdated);
+}
+
+void FDungeonRoomDatabase::UnsubscribeFromAssetRegistry()
+{
+	// the registry may already be gone during engine shutdown
+	FAssetRegistryModule* AssetRegistryModule{ FModuleManager::GetModulePtr<FAssetRegistryModule>(TEXT("AssetRegistry")) };
+	if (!AssetRegistryModule)
+	{
+		return;
+	}
+
+	IAssetRegistry& AssetRegistry{ AssetRegistryModule->Get() };
+	AssetRegistry.OnAssetAdded().Remove(m_OnAssetAddedHandle);
+	AssetRegistry.OnAssetRemoved().Remove(m_OnAssetRemovedHandle);
+	AssetRegistry.OnAssetRenamed().Remove(m_OnAssetRenamedHandle);
+	AssetRegistry.OnAssetUpdated().Remove(m_OnAssetUpdatedHandle);
+}
+
+bool FDungeonRoomDatabase::IsRoomAssetInPath(const FAssetData& Asset) const
+{
+	if (!FPaths::IsUnderDirectory(Asset.PackagePath.ToString(), m_PathToAssets.ToString()))
+	{
+		return false;
+	}
+
+	FString NativeParentClassPath;
+	if (!Asset.GetTagValue(FBlueprintTags::NativeParentClassPath, NativeParentClassPath))
+	{
+		return false;
+	}
+
+	const UClass* NativeParentClass{ FSoftClassPath{ FPackageName::ExportTextPathToObjectPath(NativeParentClassPath) }.ResolveClass() };
+	return NativeParentClass && NativeParentClass->IsChildOf(ADungeonRoom::StaticClass());
+}
+
+void FDungeonRoomDatabase::OnAssetAdded(const FAssetData& Asset)
+{
+	if (IsRoomAssetInPath(Asset))
+	{
+		const FRoomAssetRecord Record{ ExtractRecord(Asset) };
+		if (!m_RecordsByPath.Contains(Record.Path))
+		{
+			AddRecordToDatabase(Record);
+			m_bIsDerivedDataStale = true;
+		}
+	}
+}
+
+void FDungeonRoomDatabase::OnAssetRemoved(const FAssetData& Asset)
+{
+	RemovePathFromDatabase(FDungeonRoomAssetAnalyzer::GetSoftObjectPath(Asset));
+}
+
+void FDungeonRoomDatabase::OnAssetRenamed(const FAssetData& Asset, const FString& OldObjectPath)
+{
+	RemovePathFromDatabase(FSoftObjectPath{ OldObjectPath });
+	
+	OnAssetAdded(Asset);
+}
+
+void FDungeonRoomDatabase::OnAssetUpdated(const FAssetData& Asset)
+{
+	// the room's specs may have been edited, so it is filed again under its current specs
+	RemovePathFromDatabase(FDungeonRoomAssetAnalyzer::GetSoftObjectPath(Asset));
+
+	OnAssetAdded(Asset);
+}
+#endif
+
+void FDungeonRoomDatabase::BuildDerivedData() const
+{
+	BuildThemeIndices();
+
+	BuildAliasTables();
+
+	BuildAssetIndices();
+
+	m_bIsDerivedDataStale.store(false, std::memory_order_release);
+}
+
+void FDungeonRoomDatabase::BuildAssetIndices() const
+{
+	m_RecordsByPath.GenerateKeyArray(m_PathsByAssetIndex);
+
+	// sorted by path rather than by insertion, so every process holding the same assets agrees on the indices
+	m_PathsByAssetIndex.Sort(&PathLess);
+
+	m_AssetIndexByPath.Empty(m_PathsByAssetIndex.Num());
+	for (int32 AssetIndex{ 0 }; AssetIndex < m_PathsByAssetIndex.Num(); ++AssetIndex)
+	{
+		m_AssetIndexByPath.Add(m_PathsByAssetIndex[AssetIndex], AssetIndex);
+	}
+}
+
+int32 FDungeonRoomDatabase::GetNumAssets() const
+{
+	return m_RecordsByPath.Num();
+}
+
+int32 FDungeonRoomDatabase::GetAssetIndex(const FSoftObjectPath& Path) const
+{
+	RefreshStaleDerivedData();
+
+	const int32* AssetIndex{ m_AssetIndexByPath.Find(Path) };
+	return AssetIndex ? *AssetIndex : INDEX_NONE;
+}
+
+const FSoftObjectPath* FDungeonRoomDatabase::FindAssetPath(int32 AssetIndex) const
+{
+	RefreshStaleDerivedData();
+
+	return m_PathsByAssetIndex.IsValidIndex(AssetIndex) ? &m_PathsByAssetIndex[AssetIndex] : nullptr;
+}
+
+void FDungeonRoomDatabase::MeasureAssetSizes()
+{
+	for (TPair<FSoftObjectPath, FRoomAssetRecord>& Pair : m_RecordsByPath)
+	{
+		UObject* LoadedAsset{ Pair.Key.TryLoad() };
+		if (!LoadedAsset)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Warning: Failed to load room asset to measure its size: %s"), *Pair.Key.ToString());
+			continue;
+		}
+
+		Pair.Value.EstimatedSize = MeasureAssetSize(LoadedAsset);
+	}
+}
+
+int64 FDungeonRoomDatabase::MeasureAssetSize(UObject* LoadedAsset)
+{
+	UClass* RoomClass{ FBaseBlueprintAssetAnalyzer::GetSpawnableClass(LoadedAsset) };
+	if (!RoomClass)
+	{
+		return 0;
+	}
+
+	int64 SizeBytes{ RoomClass->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal) };
+
+	// the meshes are what a room actually costs, and live in their own packages
+	if (const ADungeonRoom* DefaultRoom{ Cast<ADungeonRoom>(RoomClass->GetDefaultObject()) })
+	{
+		TArray<UStaticMesh*> Meshes;
+		DefaultRoom->GetSegmentMeshes(Meshes);
+		for (UStaticMesh* Mesh : Meshes)
+		{
+			SizeBytes += Mesh->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+	}
+
+	return SizeBytes;
+}
+
+int64 FDungeonRoomDatabase::GetEstimatedAssetSize(const FSoftObjectPath& Path) const
+{
+	const FRoomAssetRecord* Record{ m_RecordsByPath.Find(Path) };
+	return Record ? Record->EstimatedSize : 0;
+}
+
+SIZE_T FDungeonRoomDatabase::GetAllocatedSize() const
+{
+	// the derived data is rebuilt first, so the result matches the database once it is in use
+	PrepareForConcurrentReads();
+
+	SIZE_T AllocatedSize{ m_PathsByRoomSpecs.GetAllocatedSize() + m_RecordsByPath.GetAllocatedSize() };
+	for (const TPair<FDungeonRoomSpecs, TArray<FSoftObjectPath>>& Pair : m_PathsByRoomSpecs)
+	{
+		AllocatedSize += Pair.Value.GetAllocatedSize();
+	}
+
+	AllocatedSize += m_MaxWidthByTheme.GetAllocatedSize() + m_MaxLengthByTheme.GetAllocatedSize() + m_ThemesWithStaleMaxima.GetAllocatedSize();
+
+	AllocatedSize += m_IndexByTheme.GetAllocatedSize();
+	for (const TPair<EDungeonTheme, FThemeIndex>& Pair : m_IndexByTheme)
+	{
+		const FThemeIndex& Index{ Pair.Value };
+		AllocatedSize += Index.PathsByWidth.GetAllocatedSize() + Index.DimensionsByWidth.GetAllocatedSize()
+			+ Index.PathsByLength.GetAllocatedSize() + Index.DimensionsByLength.GetAllocatedSize();
+		for (int32 WallIndex{ 0 }; WallIndex < FDoorLayout::NumWalls; ++WallIndex)
+		{
+			AllocatedSize += Index.PathsByDoorSlots[WallIndex].GetAllocatedSize() + Index.NumDoorSlots[WallIndex].GetAllocatedSize();
+		}
+	}
+
+	AllocatedSize += m_AliasTablesBySpecs.GetAllocatedSize();
+	for (const TPair<FDungeonRoomSpecs, FAliasTable>& Pair : m_AliasTablesBySpecs)
+	{
+		AllocatedSize += Pair.Value.GetAllocatedSize();
+	}
+
+	AllocatedSize += m_PathsByAssetIndex.GetAllocatedSize() + m_AssetIndexByPath.GetAllocatedSize();
+
+	return AllocatedSize;
+}
+
+void FDungeonRoomDatabase::BuildAliasTables() const
+{
+	m_AliasTablesBySpecs.Empty(m_PathsByRoomSpecs.Num());
+
+	TArray<float> Weights;
+	for (const TPair<FDungeonRoomSpecs, TArray<FSoftObjectPath>>& Pair : m_PathsByRoomSpecs)
+	{
+		Weights.Reset(Pair.Value.Num());
+		for (const FSoftObjectPath& Path : Pair.Value)
+		{
+			Weights.Add(m_RecordsByPath.FindChecked(Path).Weight);
+		}
+
+		m_AliasTablesBySpecs.Add(Pair.Key, FAliasTable{ Weights });
+	}
+}
+
+void FDungeonRoomDatabase::BuildThemeIndices() const
+{
+	struct FEntry
+	{
+		FIntPoint 		Dimensions;	// (width, length)
+		const FSoftObjectPath* 	Path;
+	};
+
+	TMap<EDungeonTheme, TArray<FEntry>> EntriesByTheme;
+	for (const TPair<FDungeonRoomSpecs, TArray<FSoftObjectPath>>& Pair : m_PathsByRoomSpecs)
+	{
+		TArray<FEntry>& Entries{ EntriesByTheme.FindOrAdd(Pair.Key.Theme) };
+
+		const FIntPoint Dimensions{ Pair.Key.Dimensions.Width, Pair.Key.Dimensions.Length };
+		for (const FSoftObjectPath& Path : Pair.Value)
+		{
+			Entries.Add({ Dimensions, &Path });
+		}
+	}
+
+	m_IndexByTheme.Empty(EntriesByTheme.Num());
+	for (TPair<EDungeonTheme, TArray<FEntry>>& Pair : EntriesByTheme)
+	{
+		TArray<FEntry>& Entries{ Pair.Value };
+		FThemeIndex& Index{ m_IndexByTheme.Add(Pair.Key) };
+
+		Index.PathsByWidth.Reserve(Entries.Num());
+		Index.DimensionsByWidth.Reserve(Entries.Num());
+		Entries.Sort([](const FEntry& A, const FEntry& B) { return LexicographicLess(A.Dimensions, B.Dimensions); });
+		for (const FEntry& Entry : Entries)
+		{
+			Index.PathsByWidth.Add(*Entry.Path);
+			Index.DimensionsByWidth.Add(Entry.Dimensions);
+		}
+
+		Index.PathsByLength.Reserve(Entries.Num());
+		Index.DimensionsByLength.Reserve(Entries.Num());
+		Entries.Sort([](const FEntry& A, const FEntry& B) {
+			return LexicographicLess({ A.Dimensions.Y, A.Dimensions.X }, { B.Dimensions.Y, B.Dimensions.X });
+		});
+		for (const FEntry& Entry : Entries)
+		{
+			Index.PathsByLength.Add(*Entry.Path);
+			Index.DimensionsByLength.Add({ Entry.Dimensions.Y, Entry.Dimensions.X });
+		}
+
+		for (int32 WallIndex{ 0 }; WallIndex < FDoorLayout::NumWalls; ++WallIndex)
+		{
+			const EDirection Wall{ FDoorLayout::WallDirections[WallIndex] };
+
+			// ties are broken by path, so the order does not depend on the order the specs were visited in
+			TArray<TPair<int32, const FSoftObjectPath*>> SlotCounts;
+			SlotCounts.Reserve(Entries.Num());
+			for (const FEntry& Entry : Entries)
+			{
+				SlotCounts.Add({ m_RecordsByPath.FindChecked(*Entry.Path).DoorSlots.GetNumDoors(Wall), Entry.Path });
+			}
+			SlotCounts.Sort([](const TPair<int32, const FSoftObjectPath*>& A, const TPair<int32, const FSoftObjectPath*>& B)
+			{
+				return A.Key != B.Key ? A.Key < B.Key : PathLess(*A.Value, *B.Value);
+			});
+
+			Index.PathsByDoorSlots[WallIndex].Reserve(SlotCounts.Num());
+			Index.NumDoorSlots[WallIndex].Reserve(SlotCounts.Num());
+			for (const TPair<int32, const FSoftObjectPath*>& SlotCount : SlotCounts)
+			{
+				Index.PathsByDoorSlots[WallIndex].Add(*SlotCount.Value);
+				Index.NumDoorSlots[WallIndex].Add(SlotCount.Key);
+			}
+		}
+	}
+}
+
+FDungeonRoomDatabase::FAssetPathViews FDungeonRoomDatabase::GetAssetPathsFitting(EDungeonTheme Theme, FNumberOfTiles MaxWidth, FNumberOfTiles MaxLength) const
+{
+	RefreshStaleDerivedData();
+
+	FAssetPathViews Views;
+
+	const FThemeIndex* Index{ m_IndexByTheme.Find(Theme) };
+	if (!Index)
+	{
+		return Views;
+	}
+
+	const TArray<FIntPoint>& Dimensions{ Index->DimensionsByWidth };
+	const int32 End{ UpperBound(Dimensions, { MaxWidth, MAX_int32 }) };
+	
+	// every width group is sorted by length, so the fitting rooms of each width form a prefix of its group
+	int32 GroupBegin{ 0 };
+	while (GroupBegin < End)
+	{
+		const int32 Width{ Dimensions[GroupBegin].X };
+		const int32 GroupEnd{ UpperBound(Dimensions, { Width, MAX_int32 }) };
+		const int32 FittingEnd{ UpperBound(Dimensions, { Width, MaxLength }) };
+
+		if (FittingEnd > GroupBegin)
+		{
+			Views.Add(TArrayView<const FSoftObjectPath>{ Index->PathsByWidth.GetData() + GroupBegin, FittingEnd - GroupBegin });
+		}
+
+		GroupBegin = GroupEnd;
+	}
+
+	return Views;
+}
+
+TArrayView<const FSoftObjectPath> FDungeonRoomDatabase::GetLargestAssetPathsFitting(EDungeonTheme Theme, FNumberOfTiles MaxWidth, FNumberOfTiles MaxLength) const
+{
+	RefreshStaleDerivedData();
+
+	const FThemeIndex* Index{ m_IndexByTheme.Find(Theme) };
+	if (!Index)
+	{
+		return { };
+	}
+
+	const TArray<FIntPoint>& Dimensions{ Index->DimensionsByWidth };
+	const int32 End{ UpperBound(Dimensions, { MaxWidth, MAX_int32 }) };
+
+	int64 LargestArea{ 0 };
+	int32 LargestBegin{ INDEX_NONE };
+	int32 LargestEnd{ INDEX_NONE };
+
+	// the longest fitting room of each width is its best candidate, and it sits at the end of the width's fitting prefix
+	int32 GroupBegin{ 0 };
+	while (GroupBegin < End)
+	{
+		const int32 Width{ Dimensions[GroupBegin].X };
+		const int32 GroupEnd{ UpperBound(Dimensions, { Width, MAX_int32 }) };
+		const int32 FittingEnd{ UpperBound(Dimensions, { Width, MaxLength }) };
+
+		if (FittingEnd > GroupBegin)
+		{
+			const FIntPoint& Candidate{ Dimensions[FittingEnd - 1] };
+			const int64 Area{ static_cast<int64>(Candidate.X) * Candidate.Y };
+			if (Area >= LargestArea)
+			{
+				LargestArea  = Area;
+				LargestBegin = Algo::LowerBound(Dimensions, Candidate, &LexicographicLess);
+				LargestEnd   = FittingEnd;
+			}
+		}
+
+		GroupBegin = GroupEnd;
+	}
+
+	if (LargestBegin == INDEX_NONE)
+	{
+		return { };
+	}
+
+	return TArrayView<const FSoftObjectPath>{ Index->PathsByWidth.GetData() + LargestBegin, LargestEnd - LargestBegin };
+}
+
+TArrayView<const FSoftObjectPath> FDungeonRoomDatabase::GetAssetPathsWithDoorSlots(EDungeonTheme Theme, EDirection Side, FNumberOfTiles MinDoorSlots) const
+{
+	RefreshStaleDerivedData();
+
+	const FThemeIndex* Index{ m_IndexByTheme.Find(Theme) };
+	if (!Index)
+	{
+		return { };
+	}
+
+	const int32 WallIndex{ FDoorLayout::GetWallIndex(Side) };
+	const TArray<FSoftObjectPath>& Paths{ Index->PathsByDoorSlots[WallIndex] };
+
+	const int32 Begin{ Algo::LowerBound(Index->NumDoorSlots[WallIndex], static_cast<int32>(MinDoorSlots)) };
+
+	return TArrayView<const FSoftObjectPath>{ Paths.GetData() + Begin, Paths.Num() - Begin };
+}
+
 
 
@@ -0,0 +1,34 @@
+#include "DungeonRoomDatabaseCommandlet.h"
+
+#include "DungeonRoomDatabase.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+
+int32 UDungeonRoomDatabaseCommandlet::Main(const FString& Params)
+{
+	FString PathToAssets;
+	if (!FParse::Value(*Params, TEXT("Path="), PathToAssets))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: No asset path given; usage: -run=DungeonRoomDatabase -Path=/Game/Dungeon/Rooms"));
+		return 1;
+	}
+
+	// commandlets start before the Asset Registry has finished discovering assets
+	IAssetRegistry& AssetRegistry{ FAssetRegistryModule::GetRegistry() };
+	AssetRegistry.SearchAllAssets(/*bSynchronousSearch*/ true);
+
+	const FName Path{ *PathToAssets };
+	FDungeonRoomDatabase Database{ Path };
+
+	// the meshes a room references are only known once it is loaded, which cooked builds should not need to do for every room
+	Database.MeasureAssetSizes();
+
+	const FString SnapshotFilePath{ FDungeonRoomDatabase::GetSnapshotFilePath(Path) };
+	if (!Database.SaveSnapshot(SnapshotFilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Failed to write room database snapshot: %s"), *SnapshotFilePath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Wrote room database snapshot: %s"), *SnapshotFilePath);
+	return 0;
+}
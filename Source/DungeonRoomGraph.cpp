@@ -0,0 +1,217 @@
+#include "DungeonRoomGraph.h"
+
+void FDungeonRoomGraph::AddRoom(int32 RoomIndex)
+{
+	checkf(RoomIndex == m_EdgesByRoom.Num(), TEXT("Error: Rooms must be added to the room graph in index order"));
+
+	m_EdgesByRoom.AddDefaulted();
+	m_Parents.Add(RoomIndex);
+	++m_NumComponents;
+}
+
+int32 FDungeonRoomGraph::GetNumRooms() const
+{
+	return m_EdgesByRoom.Num();
+}
+
+int32 FDungeonRoomGraph::GetNumEdges() const
+{
+	return m_Edges.Num();
+}
+
+void FDungeonRoomGraph::Connect(const FRoomDoor& Door, const FRoomDoor& FacingDoor)
+{
+	checkf(!IsConnected(Door) && !IsConnected(FacingDoor), TEXT("Error: Attempted to connect a door that is already connected"));
+
+	const int32 EdgeIndex{ m_Edges.Add(FRoomEdge{ { Door, FacingDoor } }) };
+
+	m_EdgeIndexByDoor.Add(Door, EdgeIndex);
+	m_EdgeIndexByDoor.Add(FacingDoor, EdgeIndex);
+
+	m_EdgesByRoom[Door.RoomIndex].Add(EdgeIndex);
+	m_EdgesByRoom[FacingDoor.RoomIndex].Add(EdgeIndex);
+
+	if (!m_bIsConnectivityStale)
+	{
+		Union(Door.RoomIndex, FacingDoor.RoomIndex);
+	}
+}
+
+void FDungeonRoomGraph::Disconnect(const FRoomDoor& Door)
+{
+	int32 EdgeIndex{ INDEX_NONE };
+	if (!m_EdgeIndexByDoor.RemoveAndCopyValue(Door, EdgeIndex))
+	{
+		return;
+	}
+
+	const FRoomEdge Edge{ m_Edges[EdgeIndex] };
+	m_Edges.RemoveAt(EdgeIndex);
+
+	for (const FRoomDoor& EdgeDoor : Edge.Doors)
+	{
+		m_EdgeIndexByDoor.Remove(EdgeDoor);
+		m_EdgesByRoom[EdgeDoor.RoomIndex].RemoveSingleSwap(EdgeIndex);
+	}
+
+	// union-find cannot split sets, so they are rebuilt lazily
+	m_bIsConnectivityStale = true;
+}
+
+bool FDungeonRoomGraph::IsConnected(const FRoomDoor& Door) const
+{
+	return m_EdgeIndexByDoor.Contains(Door);
+}
+
+void FDungeonRoomGraph::GetNeighbors(int32 RoomIndex, TArray<int32>& OutNeighborIndices) const
+{
+	for (const int32 EdgeIndex : m_EdgesByRoom[RoomIndex])
+	{
+		const FRoomEdge& Edge{ m_Edges[EdgeIndex] };
+		OutNeighborIndices.Add(Edge.Doors[0].RoomIndex == RoomIndex ? Edge.Doors[1].RoomIndex : Edge.Doors[0].RoomIndex);
+	}
+}
+
+bool FDungeonRoomGraph::AreConnected(int32 RoomA, int32 RoomB) const
+{
+	RefreshConnectivity();
+	return FindRoot(RoomA) == FindRoot(RoomB);
+}
+
+int32 FDungeonRoomGraph::GetNumComponents() const
+{
+	RefreshConnectivity();
+	return m_NumComponents;
+}
+
+bool FDungeonRoomGraph::IsFullyConnected() const
+{
+	return GetNumComponents() <= 1;
+}
+
+bool FDungeonRoomGraph::HasLoop() const
+{
+	// a forest has exactly one edge fewer than rooms per component; any additional edge closes a loop
+	return GetNumEdges() > GetNumRooms() - GetNumComponents();
+}
+
+int32 FDungeonRoomGraph::GetDistance(int32 RoomA, int32 RoomB) const
+{
+	if (!AreConnected(RoomA, RoomB))
+	{
+		return INDEX_NONE;
+	}
+
+	TArray<int32> Distances;
+	GetDistances(RoomA, Distances);
+	return Distances[RoomB];
+}
+
+void FDungeonRoomGraph::GetDistances(int32 SourceRoom, TArray<int32>& OutDistances) const
+{
+	GetDistances(MakeArrayView(&SourceRoom, 1), OutDistances);
+}
+
+void FDungeonRoomGraph::GetDistances(TConstArrayView<int32> SourceRooms, TArray<int32>& OutDistances) const
+{
+	OutDistances.Init(INDEX_NONE, GetNumRooms());
+
+	TArray<int32> Frontier;
+	for (const int32 SourceRoom : SourceRooms)
+	{
+		if (OutDistances[SourceRoom] == INDEX_NONE)
+		{
+			OutDistances[SourceRoom] = 0;
+			Frontier.Add(SourceRoom);
+		}
+	}
+
+	TArray<int32> Neighbors;
+	for (int32 FrontierIndex{ 0 }; FrontierIndex < Frontier.Num(); ++FrontierIndex)
+	{
+		const int32 RoomIndex{ Frontier[FrontierIndex] };
+
+		Neighbors.Reset();
+		GetNeighbors(RoomIndex, Neighbors);
+
+		for (const int32 NeighborIndex : Neighbors)
+		{
+			if (OutDistances[NeighborIndex] == INDEX_NONE)
+			{
+				OutDistances[NeighborIndex] = OutDistances[RoomIndex] + 1;
+				Frontier.Add(NeighborIndex);
+			}
+		}
+	}
+}
+
+void FDungeonRoomGraph::Reset()
+{
+	m_Edges.Empty();
+	m_EdgeIndexByDoor.Empty();
+	m_EdgesByRoom.Empty();
+	m_Parents.Empty();
+	m_NumComponents = 0;
+	m_bIsConnectivityStale = false;
+}
+
+SIZE_T FDungeonRoomGraph::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize{ m_Edges.GetAllocatedSize() + m_EdgeIndexByDoor.GetAllocatedSize() + m_EdgesByRoom.GetAllocatedSize() + m_Parents.GetAllocatedSize() };
+	for (const TArray<int32, TInlineAllocator<4>>& RoomEdges : m_EdgesByRoom)
+	{
+		// inline elements are part of m_EdgesByRoom's own allocation, so this only counts lists that spilled onto the heap
+		AllocatedSize += RoomEdges.GetAllocatedSize();
+	}
+	return AllocatedSize;
+}
+
+int32 FDungeonRoomGraph::FindRoot(int32 RoomIndex) const
+{
+	int32 Root{ RoomIndex };
+	while (m_Parents[Root] != Root)
+	{
+		Root = m_Parents[Root];
+	}
+
+	while (m_Parents[RoomIndex] != Root)
+	{
+		const int32 Parent{ m_Parents[RoomIndex] };
+		m_Parents[RoomIndex] = Root;
+		RoomIndex = Parent;
+	}
+
+	return Root;
+}
+
+void FDungeonRoomGraph::Union(int32 RoomA, int32 RoomB) const
+{
+	const int32 RootA{ FindRoot(RoomA) };
+	const int32 RootB{ FindRoot(RoomB) };
+	if (RootA != RootB)
+	{
+		m_Parents[RootB] = RootA;
+		--m_NumComponents;
+	}
+}
+
+void FDungeonRoomGraph::RefreshConnectivity() const
+{
+	if (!m_bIsConnectivityStale)
+	{
+		return;
+	}
+
+	for (int32 RoomIndex{ 0 }; RoomIndex < m_Parents.Num(); ++RoomIndex)
+	{
+		m_Parents[RoomIndex] = RoomIndex;
+	}
+	m_NumComponents = m_Parents.Num();
+
+	for (const FRoomEdge& Edge : m_Edges)
+	{
+		Union(Edge.Doors[0].RoomIndex, Edge.Doors[1].RoomIndex);
+	}
+
+	m_bIsConnectivityStale = false;
+}
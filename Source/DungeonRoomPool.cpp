@@ -0,0 +1,58 @@
+#include "DungeonRoomPool.h"
+
+#include "Dungeon/Rooms/DungeonRoom.h"
+
+ADungeonRoom* UDungeonRoomPool::Acquire(UClass* RoomClass, const FVector& Location)
+{
+	FPooledDungeonRooms* PooledRooms{ m_RoomsByClass.Find(RoomClass) };
+	if (!PooledRooms)
+	{
+		return nullptr;
+	}
+
+	while (PooledRooms->Rooms.Num() > 0)
+	{
+		ADungeonRoom* Room{ PooledRooms->Rooms.Pop(EAllowShrinking::No) };
+
+		// rooms can be destroyed by other systems while pooled, such as during level streaming
+		if (IsValid(Room))
+		{
+			Room->Activate(Location);
+			return Room;
+		}
+	}
+
+	return nullptr;
+}
+
+void UDungeonRoomPool::Release(ADungeonRoom* Room)
+{
+	checkf(Room, TEXT("Error: Attempted to release a null room to the pool"));
+
+	FPooledDungeonRooms& PooledRooms{ m_RoomsByClass.FindOrAdd(Room->GetClass()) };
+	checkf(!PooledRooms.Rooms.Contains(Room), TEXT("Error: Attempted to release a room to the pool twice: %s"), *Room->GetPathName());
+
+	Room->Deactivate();
+	PooledRooms.Rooms.Add(Room);
+}
+
+int32 UDungeonRoomPool::GetNumPooledRooms(UClass* RoomClass) const
+{
+	const FPooledDungeonRooms* PooledRooms{ m_RoomsByClass.Find(RoomClass) };
+	return PooledRooms ? PooledRooms->Rooms.Num() : 0;
+}
+
+void UDungeonRoomPool::Empty()
+{
+	for (TPair<UClass*, FPooledDungeonRooms>& Pair : m_RoomsByClass)
+	{
+		for (ADungeonRoom* Room : Pair.Value.Rooms)
+		{
+			if (IsValid(Room))
+			{
+				Room->Destroy();
+			}
+		}
+	}
+	m_RoomsByClass.Empty();
+}
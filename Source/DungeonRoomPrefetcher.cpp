@@ -0,0 +1,224 @@
+#include "DungeonRoomPrefetcher.h"
+
+#include "Dungeon/DungeonStats.h"
+#include "Algo/Reverse.h"
+
+FDungeonRoomPrefetcher::FDungeonRoomPrefetcher(TSharedPtr<const FDungeonRoomDatabase> Database, int64 MemoryBudgetBytes, int32 MaxLoadsInFlight)
+	: m_Database{ MoveTemp(Database) }
+	, m_MemoryBudgetBytes{ MemoryBudgetBytes }
+	, m_MaxLoadsInFlight{ FMath::Max(MaxLoadsInFlight, 1) }
+{
+	checkf(m_Database.IsValid(), TEXT("Error: Attempted to create a room prefetcher without a database"));
+}
+
+FDungeonRoomPrefetcher::~FDungeonRoomPrefetcher()
+{
+	Reset();
+}
+
+void FDungeonRoomPrefetcher::PrefetchFloor(EDungeonTheme Theme, const FDungeonLayout* Layout)
+{
+	TArray<FSoftObjectPath> AssetPaths;
+
+	// the layout names the exact assets the floor spawns, so they are worth more than the rest of the theme
+	if (Layout)
+	{
+		for (const FDungeonLayoutRoom& Room : Layout->GetRooms())
+		{
+			AssetPaths.AddUnique(Room.AssetPath);
+		}
+	}
+
+	TArray<FDungeonRoomSpecs> ThemeSpecs;
+	m_Database->GetRoomSpecs(Theme, ThemeSpecs);
+	for (const FDungeonRoomSpecs& Specs : ThemeSpecs)
+	{
+		for (const FSoftObjectPath& AssetPath : m_Database->GetAssetPaths(Specs))
+		{
+			AssetPaths.AddUnique(AssetPath);
+		}
+	}
+
+	Enqueue(AssetPaths);
+}
+
+void FDungeonRoomPrefetcher::PrefetchLayout(const FDungeonLayout& Layout)
+{
+	TArray<FSoftObjectPath> AssetPaths;
+	for (const FDungeonLayoutRoom& Room : Layout.GetRooms())
+	{
+		AssetPaths.AddUnique(Room.AssetPath);
+	}
+
+	Enqueue(AssetPaths);
+}
+
+void FDungeonRoomPrefetcher::MarkUsed(const FSoftObjectPath& AssetPath)
+{
+	if (FPrefetchEntry* Entry{ m_Entries.Find(AssetPath) })
+	{
+		Entry->LastUsed = ++m_UseCounter;
+	}
+}
+
+bool FDungeonRoomPrefetcher::IsLoaded(const FSoftObjectPath& AssetPath) const
+{
+	const FPrefetchEntry* Entry{ m_Entries.Find(AssetPath) };
+	return Entry && Entry->bIsLoaded;
+}
+
+void FDungeonRoomPrefetcher::SetMemoryBudget(int64 MemoryBudgetBytes)
+{
+	m_MemoryBudgetBytes = MemoryBudgetBytes;
+
+	// an explicit budget change is allowed to release the current floor's assets as well
+	EvictToBudget(MAX_uint64);
+	RequestQueuedAssets();
+}
+
+int64 FDungeonRoomPrefetcher::GetLoadedBytes() const
+{
+	return m_LoadedBytes;
+}
+
+int32 FDungeonRoomPrefetcher::GetNumQueued() const
+{
+	return m_Queue.Num();
+}
+
+void FDungeonRoomPrefetcher::Reset()
+{
+	for (TPair<FSoftObjectPath, FPrefetchEntry>& Pair : m_Entries)
+	{
+		const TSharedPtr<FStreamableHandle>& Handle{ Pair.Value.Handle };
+		if (!Handle.IsValid())
+		{
+			continue;
+		}
+
+		// every handle is cancelled rather than only those still loading: the delegate of an asset that was already loaded
+		// is deferred to a later tick, and a cancelled handle never calls it, so nothing refers to the prefetcher afterwards
+		Handle->CancelHandle();
+	}
+
+	m_Entries.Empty();
+	m_Queue.Empty();
+	m_LoadedBytes	   = 0;
+	m_NumLoadsInFlight = 0;
+
+	SET_MEMORY_STAT(STAT_DungeonPrefetchedMemory, 0);
+}
+
+void FDungeonRoomPrefetcher::Enqueue(TConstArrayView<FSoftObjectPath> AssetPaths)
+{
+	m_Queue.Reset(AssetPaths.Num());
+	m_FloorStartUse = m_UseCounter + 1;
+
+	for (const FSoftObjectPath& AssetPath : AssetPaths)
+	{
+		if (FPrefetchEntry* Entry{ m_Entries.Find(AssetPath) })
+		{
+			Entry->LastUsed = ++m_UseCounter;
+		}
+		else
+		{
+			m_Queue.Add(AssetPath);
+		}
+	}
+
+	// the queue is consumed from the back, so the most wanted asset goes last
+	Algo::Reverse(m_Queue);
+
+	RequestQueuedAssets();
+}
+
+void FDungeonRoomPrefetcher::RequestQueuedAssets()
+{
+	while (m_Queue.Num() > 0 && m_NumLoadsInFlight < m_MaxLoadsInFlight)
+	{
+		if (m_LoadedBytes > m_MemoryBudgetBytes && !EvictToBudget(m_FloorStartUse))
+		{
+			return;
+		}
+
+		const FSoftObjectPath AssetPath{ m_Queue.Pop(EAllowShrinking::No) };
+
+		// the entry exists before the request, since an asset that is already loaded completes immediately
+		FPrefetchEntry& Entry{ m_Entries.Add(AssetPath) };
+		Entry.LastUsed = ++m_UseCounter;
+		++m_NumLoadsInFlight;
+
+		TSharedPtr<FStreamableHandle> Handle{ m_StreamableManager.RequestAsyncLoad(AssetPath,
+			FStreamableDelegate::CreateRaw(this, &FDungeonRoomPrefetcher::OnAssetLoaded, AssetPath), PrefetchPriority) };
+
+		// the entry is looked up again, since completing immediately may have requested further assets
+		if (FPrefetchEntry* RequestedEntry{ m_Entries.Find(AssetPath) })
+		{
+			RequestedEntry->Handle = MoveTemp(Handle);
+		}
+	}
+}
+
+void FDungeonRoomPrefetcher::OnAssetLoaded(FSoftObjectPath AssetPath)
+{
+	--m_NumLoadsInFlight;
+
+	FPrefetchEntry* Entry{ m_Entries.Find(AssetPath) };
+	if (!Entry)
+	{
+		return;
+	}
+
+	if (UObject* LoadedAsset{ AssetPath.ResolveObject() })
+	{
+		Entry->SizeBytes = FDungeonRoomDatabase::MeasureAssetSize(LoadedAsset);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Warning: Failed to prefetch room asset: %s"), *AssetPath.ToString());
+	}
+
+	Entry->bIsLoaded = true;
+	m_LoadedBytes += Entry->SizeBytes;
+
+	EvictToBudget(m_FloorStartUse);
+	RequestQueuedAssets();
+
+	SET_MEMORY_STAT(STAT_DungeonPrefetchedMemory, m_LoadedBytes);
+}
+
+bool FDungeonRoomPrefetcher::EvictToBudget(uint64 MinProtectedUse)
+{
+	while (m_LoadedBytes > m_MemoryBudgetBytes)
+	{
+		// entries are few, so a scan is cheaper than keeping a second structure ordered by recency
+		const FSoftObjectPath* LeastRecentlyUsed{ nullptr };
+		uint64 OldestUse{ MAX_uint64 };
+		for (const TPair<FSoftObjectPath, FPrefetchEntry>& Pair : m_Entries)
+		{
+			const FPrefetchEntry& Entry{ Pair.Value };
+			if (Entry.bIsLoaded && Entry.LastUsed < MinProtectedUse && Entry.LastUsed < OldestUse)
+			{
+				LeastRecentlyUsed = &Pair.Key;
+				OldestUse	  = Entry.LastUsed;
+			}
+		}
+
+		if (!LeastRecentlyUsed)
+		{
+			return false;
+		}
+
+		const FSoftObjectPath AssetPath{ *LeastRecentlyUsed };
+		FPrefetchEntry& Entry{ m_Entries[AssetPath] };
+		if (Entry.Handle.IsValid())
+		{
+			Entry.Handle->ReleaseHandle();
+		}
+		m_LoadedBytes -= Entry.SizeBytes;
+		m_Entries.Remove(AssetPath);
+	}
+
+	SET_MEMORY_STAT(STAT_DungeonPrefetchedMemory, m_LoadedBytes);
+	return true;
+}
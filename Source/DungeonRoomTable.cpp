@@ -0,0 +1,202 @@
+#include "DungeonRoomTable.h"
+
+void FDungeonRoomTable::AddRoom(int32 RoomIndex, const FTileFootprint& Footprint, const FDoorLayout& Doors)
+{
+	checkf(RoomIndex == Num(), TEXT("Error: Rooms must be added to the room table in index order"));
+
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		const int32 WallIndex{ FDoorLayout::GetWallIndex(Direction) };
+		const int32 NumSegments{ Footprint.GetNumSegments(Direction) };
+
+		checkf((Doors.GetWallMask(Direction) & ~FDoorLayout::GetSegmentsMask(NumSegments)) == 0,
+			TEXT("Error: Attempted to add a room to the room table with doors outside of its walls"));
+
+		m_DoorMasks[WallIndex].Add(Doors.GetWallMask(Direction));
+		m_NumSegments[WallIndex].Add(static_cast<uint8>(NumSegments));
+	}
+
+	m_Origins.Add(Footprint.Origin);
+	m_Widths.Add(Footprint.Width);
+	m_Lengths.Add(Footprint.Length);
+}
+
+FDoorLayout FDungeonRoomTable::GetDoorLayout(int32 RoomIndex) const
+{
+	FDoorLayout Doors;
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		Doors.SetWallMask(Direction, m_DoorMasks[FDoorLayout::GetWallIndex(Direction)][RoomIndex]);
+	}
+	return Doors;
+}
+
+void FDungeonRoomTable::SetDoorLayout(int32 RoomIndex, const FDoorLayout& Doors)
+{
+	for (const EDirection Direction : FDoorLayout::WallDirections)
+	{
+		m_DoorMasks[FDoorLayout::GetWallIndex(Direction)][RoomIndex] = Doors.GetWallMask(Direction);
+	}
+}
+
+void FDungeonRoomTable::SetDoor(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex, bool bHasDoor)
+{
+	FDoorLayout::FWallMask& Mask{ m_DoorMasks[FDoorLayout::GetWallIndex(Wall)][RoomIndex] };
+	const FDoorLayout::FWallMask SegmentBit{ FDoorLayout::FWallMask{ 1 } << SegmentIndex };
+
+	Mask = bHasDoor ? Mask | SegmentBit : Mask & ~SegmentBit;
+}
+
+bool FDungeonRoomTable::HasDoor(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex) const
+{
+	return (m_DoorMasks[FDoorLayout::GetWallIndex(Wall)][RoomIndex] & (FDoorLayout::FWallMask{ 1 } << SegmentIndex)) != 0;
+}
+
+FTileFootprint FDungeonRoomTable::GetFootprint(int32 RoomIndex) const
+{
+	return { m_Origins[RoomIndex], m_Widths[RoomIndex], m_Lengths[RoomIndex] };
+}
+
+TConstArrayView<FDoorLayout::FWallMask> FDungeonRoomTable::GetDoorMasks(const EDirection Wall) const
+{
+	return m_DoorMasks[FDoorLayout::GetWallIndex(Wall)];
+}
+
+TConstArrayView<uint8> FDungeonRoomTable::GetNumSegments(const EDirection Wall) const
+{
+	return m_NumSegments[FDoorLayout::GetWallIndex(Wall)];
+}
+
+int32 FDungeonRoomTable::GetNumDoors() const
+{
+	// each wall is summed separately, so every loop reads a single contiguous array
+	int32 NumDoors{ 0 };
+	for (const TArray<FDoorLayout::FWallMask>& WallMasks : m_DoorMasks)
+	{
+		for (const FDoorLayout::FWallMask Mask : WallMasks)
+		{
+			NumDoors += static_cast<int32>(FMath::CountBits(Mask));
+		}
+	}
+	return NumDoors;
+}
+
+int32 FDungeonRoomTable::GetNumDoors(int32 RoomIndex) const
+{
+	int32 NumDoors{ 0 };
+	for (const TArray<FDoorLayout::FWallMask>& WallMasks : m_DoorMasks)
+	{
+		NumDoors += static_cast<int32>(FMath::CountBits(WallMasks[RoomIndex]));
+	}
+	return NumDoors;
+}
+
+void FDungeonRoomTable::FindDeadEnds(TArray<int32>& OutRoomIndices) const
+{
+	// door counts are accumulated one wall at a time for the same reason as GetNumDoors
+	TArray<uint8> NumDoorsByRoom;
+	NumDoorsByRoom.SetNumZeroed(Num());
+
+	for (const TArray<FDoorLayout::FWallMask>& WallMasks : m_DoorMasks)
+	{
+		for (int32 RoomIndex{ 0 }; RoomIndex < WallMasks.Num(); ++RoomIndex)
+		{
+			NumDoorsByRoom[RoomIndex] += static_cast<uint8>(FMath::CountBits(WallMasks[RoomIndex]));
+		}
+	}
+
+	for (int32 RoomIndex{ 0 }; RoomIndex < NumDoorsByRoom.Num(); ++RoomIndex)
+	{
+		if (NumDoorsByRoom[RoomIndex] == 1)
+		{
+			OutRoomIndices.Add(RoomIndex);
+		}
+	}
+}
+
+FIntRect FDungeonRoomTable::GetBounds() const
+{
+	if (Num() == 0)
+	{
+		return FIntRect{ };
+	}
+
+	FIntPoint Min{ MAX_int32, MAX_int32 };
+	FIntPoint Max{ MIN_int32, MIN_int32 };
+	for (int32 RoomIndex{ 0 }; RoomIndex < Num(); ++RoomIndex)
+	{
+		const FIntPoint& Origin{ m_Origins[RoomIndex] };
+		Min.X = FMath::Min(Min.X, Origin.X);
+		Min.Y = FMath::Min(Min.Y, Origin.Y);
+		Max.X = FMath::Max(Max.X, Origin.X + m_Lengths[RoomIndex]);
+		Max.Y = FMath::Max(Max.Y, Origin.Y + m_Widths[RoomIndex]);
+	}
+	return FIntRect{ Min, Max };
+}
+
+void FDungeonRoomTable::RasterizeMinimap(TArray<EMinimapTile>& OutTiles, FIntRect& OutBounds) const
+{
+	OutBounds = GetBounds();
+
+	const int32 Height{ OutBounds.Height() };
+	OutTiles.Init(EMinimapTile::Empty, OutBounds.Width() * Height);
+
+	const auto GetTile = [&OutTiles, &OutBounds, Height](const FIntPoint& Tile) -> EMinimapTile&
+	{
+		return OutTiles[(Tile.X - OutBounds.Min.X) * Height + (Tile.Y - OutBounds.Min.Y)];
+	};
+
+	for (int32 RoomIndex{ 0 }; RoomIndex < Num(); ++RoomIndex)
+	{
+		const FTileFootprint Footprint{ GetFootprint(RoomIndex) };
+		const FIntPoint End{ Footprint.GetEnd() };
+
+		// rows run along Y, so each row of the room is a contiguous run of the image
+		for (int32 X{ Footprint.Origin.X }; X < End.X; ++X)
+		{
+			EMinimapTile* Row{ &GetTile({ X, Footprint.Origin.Y }) };
+			for (int32 Offset{ 0 }; Offset < Footprint.Width; ++Offset)
+			{
+				Row[Offset] = EMinimapTile::Floor;
+			}
+		}
+
+		for (const EDirection Direction : FDoorLayout::WallDirections)
+		{
+			FDoorLayout::FWallMask Doors{ m_DoorMasks[FDoorLayout::GetWallIndex(Direction)][RoomIndex] };
+			while (Doors != 0)
+			{
+				GetTile(Footprint.GetSegmentTile(Direction, static_cast<int32>(FMath::CountTrailingZeros64(Doors)))) = EMinimapTile::Door;
+				Doors &= Doors - 1;
+			}
+		}
+	}
+}
+
+int32 FDungeonRoomTable::Num() const
+{
+	return m_Origins.Num();
+}
+
+void FDungeonRoomTable::Reset()
+{
+	for (int32 WallIndex{ 0 }; WallIndex < FDoorLayout::NumWalls; ++WallIndex)
+	{
+		m_DoorMasks[WallIndex].Reset();
+		m_NumSegments[WallIndex].Reset();
+	}
+
+	m_Origins.Reset();
+	m_Widths.Reset();
+	m_Lengths.Reset();
+}
+
+SIZE_T FDungeonRoomTable::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize{ m_Origins.GetAllocatedSize() + m_Widths.GetAllocatedSize() + m_Lengths.GetAllocatedSize() };
+	for (int32 WallIndex{ 0 }; WallIndex < FDoorLayout::NumWalls; ++WallIndex)
+	{
+		AllocatedSize += m_DoorMasks[WallIndex].GetAllocatedSize() + m_NumSegments[WallIndex].GetAllocatedSize();
+	}
+	return AllocatedSize;
+}
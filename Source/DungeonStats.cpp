@@ -0,0 +1,25 @@
+#include "DungeonStats.h"
+
+DEFINE_STAT(STAT_DungeonRoomSpawn);
+DEFINE_STAT(STAT_DungeonRoomSpawnBatch);
+DEFINE_STAT(STAT_DungeonRoomAddDoor);
+DEFINE_STAT(STAT_DungeonRoomRemoveDoor);
+DEFINE_STAT(STAT_DungeonRoomApplyDoorLayout);
+DEFINE_STAT(STAT_DungeonWallInitializeSegments);
+DEFINE_STAT(STAT_DungeonDatabaseInitialize);
+DEFINE_STAT(STAT_DungeonDatabaseLoadSnapshot);
+DEFINE_STAT(STAT_DungeonAddRoom);
+DEFINE_STAT(STAT_DungeonSpawnLayout);
+
+DEFINE_STAT(STAT_DungeonRoomsSpawned);
+DEFINE_STAT(STAT_DungeonDoorsChanged);
+DEFINE_STAT(STAT_DungeonMeshesSwapped);
+
+DEFINE_STAT(STAT_DungeonAssetsIndexed);
+DEFINE_STAT(STAT_DungeonDatabaseSnapshotBytesRead);
+
+DEFINE_STAT(STAT_DungeonPrefetchedMemory);
+
+#if !UE_BUILD_SHIPPING
+UE_TRACE_CHANNEL_DEFINE(DungeonChannel);
+#endif
@@ -0,0 +1,200 @@
+#include "DungeonTileGrid.h"
+
+FIntPoint FTileFootprint::GetSegmentTile(const EDirection Wall, const int32 SegmentIndex) const
+{
+	switch (Wall)
+	{
+		case EDirection::North: return { Origin.X + Length - 1, Origin.Y + SegmentIndex };
+		case EDirection::South: return { Origin.X, Origin.Y + SegmentIndex };
+		case EDirection::East:	return { Origin.X + SegmentIndex, Origin.Y + Width - 1 };
+		case EDirection::West:  return { Origin.X + SegmentIndex, Origin.Y };
+
+		default:
+			checkf(false, TEXT("Error: Invalid argument given to GetSegmentTile()"));
+			return Origin;
+	}
+}
+
+FIntPoint FTileFootprint::GetTileAcrossSegment(const EDirection Wall, const int32 SegmentIndex) const
+{
+	const FIntPoint SegmentTile{ GetSegmentTile(Wall, SegmentIndex) };
+
+	switch (Wall)
+	{
+		case EDirection::North: return { SegmentTile.X + 1, SegmentTile.Y };
+		case EDirection::South: return { SegmentTile.X - 1, SegmentTile.Y };
+		case EDirection::East:	return { SegmentTile.X, SegmentTile.Y + 1 };
+		case EDirection::West:  return { SegmentTile.X, SegmentTile.Y - 1 };
+
+		default:
+			checkf(false, TEXT("Error: Invalid argument given to GetTileAcrossSegment()"));
+			return SegmentTile;
+	}
+}
+
+EDirection FDungeonTileGrid::GetOppositeWall(const EDirection Wall)
+{
+	switch (Wall)
+	{
+		case EDirection::North: return EDirection::South;
+		case EDirection::South: return EDirection::North;
+		case EDirection::East:	return EDirection::West;
+		case EDirection::West:  return EDirection::East;
+
+		default:
+			checkf(false, TEXT("Error: Invalid argument given to GetOppositeWall()"));
+			return Wall;
+	}
+}
+
+bool FDungeonTileGrid::IsAreaFree(const FTileFootprint& Footprint) const
+{
+	const FIntPoint End{ Footprint.GetEnd() };
+	for (int32 X{ Footprint.Origin.X }; X < End.X; ++X)
+	{
+		for (int32 Y{ Footprint.Origin.Y }; Y < End.Y; ++Y)
+		{
+			if (m_RoomIndexByTile.Contains({ X, Y }))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void FDungeonTileGrid::AddRoom(int32 RoomIndex, const FTileFootprint& Footprint)
+{
+	checkf(!m_FootprintByRoomIndex.Contains(RoomIndex), TEXT("Error: Attempted to add a room to the tile grid twice"));
+
+	checkf(IsAreaFree(Footprint), TEXT("Error: Attempted to add a room that overlaps another room to the tile grid"));
+
+	m_FootprintByRoomIndex.Add(RoomIndex, Footprint);
+
+	const FIntPoint End{ Footprint.GetEnd() };
+	for (int32 X{ Footprint.Origin.X }; X < End.X; ++X)
+	{
+		for (int32 Y{ Footprint.Origin.Y }; Y < End.Y; ++Y)
+		{
+			m_RoomIndexByTile.Add({ X, Y }, RoomIndex);
+		}
+	}
+}
+
+void FDungeonTileGrid::RemoveRoom(int32 RoomIndex)
+{
+	FTileFootprint Footprint;
+	if (!m_FootprintByRoomIndex.RemoveAndCopyValue(RoomIndex, Footprint))
+	{
+		return;
+	}
+
+	const FIntPoint End{ Footprint.GetEnd() };
+	for (int32 X{ Footprint.Origin.X }; X < End.X; ++X)
+	{
+		for (int32 Y{ Footprint.Origin.Y }; Y < End.Y; ++Y)
+		{
+			m_RoomIndexByTile.Remove({ X, Y });
+		}
+	}
+}
+
+const FTileFootprint* FDungeonTileGrid::FindFootprint(int32 RoomIndex) const
+{
+	return m_FootprintByRoomIndex.Find(RoomIndex);
+}
+
+int32 FDungeonTileGrid::FindRoomAt(const FIntPoint& Tile) const
+{
+	const int32* RoomIndex{ m_RoomIndexByTile.Find(Tile) };
+	return RoomIndex ? *RoomIndex : INDEX_NONE;
+}
+
+void FDungeonTileGrid::FindRoomsInBox(const FTileFootprint& Box, TArray<int32>& OutRoomIndices) const
+{
+	const int64 BoxArea{ static_cast<int64>(Box.Width) * Box.Length };
+
+	// large boxes are cheaper to answer by testing every footprint than by visiting every tile
+	if (BoxArea > m_FootprintByRoomIndex.Num())
+	{
+		for (const TPair<int32, FTileFootprint>& Pair : m_FootprintByRoomIndex)
+		{
+			if (Pair.Value.Intersects(Box))
+			{
+				OutRoomIndices.Add(Pair.Key);
+			}
+		}
+		return;
+	}
+
+	const FIntPoint End{ Box.GetEnd() };
+	for (int32 X{ Box.Origin.X }; X < End.X; ++X)
+	{
+		for (int32 Y{ Box.Origin.Y }; Y < End.Y; ++Y)
+		{
+			if (const int32* RoomIndex{ m_RoomIndexByTile.Find({ X, Y }) })
+			{
+				OutRoomIndices.AddUnique(*RoomIndex);
+			}
+		}
+	}
+}
+
+int32 FDungeonTileGrid::FindNeighbor(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex) const
+{
+	const FTileFootprint& Footprint{ m_FootprintByRoomIndex.FindChecked(RoomIndex) };
+	return FindRoomAt(Footprint.GetTileAcrossSegment(Wall, SegmentIndex));
+}
+
+int32 FDungeonTileGrid::FindFacingSegment(int32 RoomIndex, const EDirection Wall, const int32 SegmentIndex) const
+{
+	const FTileFootprint& Footprint{ m_FootprintByRoomIndex.FindChecked(RoomIndex) };
+	const FIntPoint TileAcross{ Footprint.GetTileAcrossSegment(Wall, SegmentIndex) };
+
+	const int32 NeighborIndex{ FindRoomAt(TileAcross) };
+	if (NeighborIndex == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	return m_FootprintByRoomIndex.FindChecked(NeighborIndex).GetSegmentIndexAt(GetOppositeWall(Wall), TileAcross);
+}
+
+void FDungeonTileGrid::FindNeighbors(int32 RoomIndex, TArray<int32>& OutRoomIndices) const
+{
+	const FTileFootprint& Footprint{ m_FootprintByRoomIndex.FindChecked(RoomIndex) };
+
+	for (const EDirection Wall : { EDirection::North, EDirection::South, EDirection::East, EDirection::West })
+	{
+		for (int32 SegmentIndex{ 0 }; SegmentIndex < Footprint.GetNumSegments(Wall); ++SegmentIndex)
+		{
+			const int32 NeighborIndex{ FindRoomAt(Footprint.GetTileAcrossSegment(Wall, SegmentIndex)) };
+			if (NeighborIndex != INDEX_NONE)
+			{
+				OutRoomIndices.AddUnique(NeighborIndex);
+			}
+		}
+	}
+}
+
+int32 FDungeonTileGrid::Num() const
+{
+	return m_FootprintByRoomIndex.Num();
+}
+
+void FDungeonTileGrid::Reserve(int32 NumRooms, int32 NumTiles)
+{
+	m_RoomIndexByTile.Reserve(NumTiles);
+	m_FootprintByRoomIndex.Reserve(NumRooms);
+}
+
+void FDungeonTileGrid::Reset()
+{
+	m_RoomIndexByTile.Reset();
+	m_FootprintByRoomIndex.Reset();
+}
+
+SIZE_T FDungeonTileGrid::GetAllocatedSize() const
+{
+	return m_RoomIndexByTile.GetAllocatedSize() + m_FootprintByRoomIndex.GetAllocatedSize();
+}
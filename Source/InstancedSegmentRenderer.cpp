@@ -0,0 +1,90 @@
+#include "InstancedSegmentRenderer.h"
+
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+
+UInstancedSegmentRenderer::UInstancedSegmentRenderer()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UInstancedSegmentRenderer::AddSegment(UStaticMeshComponent* Segment)
+{
+	checkf(!ContainsSegment(Segment), TEXT("Error: Attempted to add a segment to the renderer twice: %s"), *Segment->GetPathName());
+
+	AddInstance(Segment);
+
+	// the batch now draws the segment, so the component no longer needs a render proxy or physics state
+	Segment->UnregisterComponent();
+}
+
+void UInstancedSegmentRenderer::SetSegmentMesh(UStaticMeshComponent* Segment, UStaticMesh* NewMesh)
+{
+	checkf(ContainsSegment(Segment), TEXT("Error: Attempted to update a segment that is not rendered by the renderer."));
+
+	RemoveInstance(Segment);
+
+	Segment->SetStaticMesh(NewMesh); // cheap since the segment is unregistered
+
+	AddInstance(Segment);
+}
+
+void UInstancedSegmentRenderer::RemoveSegment(UStaticMeshComponent* Segment)
+{
+	if (!ContainsSegment(Segment))
+	{
+		return;
+	}
+
+	RemoveInstance(Segment);
+}
+
+bool UInstancedSegmentRenderer::ContainsSegment(const UStaticMeshComponent* Segment) const
+{
+	return m_InstanceIndexBySegment.Contains(Segment);
+}
+
+UInstancedSegmentRenderer::FInstanceBatch& UInstancedSegmentRenderer::FindOrAddBatch(UStaticMesh* Mesh, const UStaticMeshComponent* Segment)
+{
+	if (FInstanceBatch* ExistingBatch{ m_BatchesByMesh.Find(Mesh) })
+	{
+		return *ExistingBatch;
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* Component{ NewObject<UHierarchicalInstancedStaticMeshComponent>(GetOwner()) };
+	Component->SetStaticMesh(Mesh);
+	Component->SetCollisionProfileName(Segment->GetCollisionProfileName());
+	Component->SetupAttachment(this);
+	Component->RegisterComponent();
+
+	m_BatchComponents.Add(Component);
+
+	return m_BatchesByMesh.Add(Mesh, FInstanceBatch{ Component, { } });
+}
+
+void UInstancedSegmentRenderer::AddInstance(UStaticMeshComponent* Segment)
+{
+	FInstanceBatch& Batch{ FindOrAddBatch(Segment->GetStaticMesh(), Segment) };
+
+	const int32 InstanceIndex{ Batch.Component->AddInstance(Segment->GetComponentTransform(), /*bWorldSpace*/ true) };
+	checkf(InstanceIndex == Batch.Segments.Num(), TEXT("Error: Instance batch is out of sync with its segments: %s"), *GetPathName());
+
+	Batch.Segments.Add(Segment);
+	m_InstanceIndexBySegment.Add(Segment, InstanceIndex);
+}
+
+void UInstancedSegmentRenderer::RemoveInstance(const UStaticMeshComponent* Segment)
+{
+	FInstanceBatch& Batch{ m_BatchesByMesh.FindChecked(Segment->GetStaticMesh()) };
+	const int32 InstanceIndex{ m_InstanceIndexBySegment.FindAndRemoveChecked(Segment) };
+
+	// the hierarchical component fills the gap by moving its last instance into the removed slot, so the owners are mirrored the same way
+	Batch.Component->RemoveInstance(InstanceIndex);
+
+	const int32 LastIndex{ Batch.Segments.Num() - 1 };
+	if (InstanceIndex != LastIndex)
+	{
+		m_InstanceIndexBySegment[Batch.Segments[LastIndex]] = InstanceIndex;
+	}
+	Batch.Segments.RemoveAtSwap(InstanceIndex);
+}
@@ -0,0 +1,71 @@
+#include "ReplicatedDungeonRooms.h"
+
+#include "Dungeon/Dungeon.h"
+
+FDoorLayout FReplicatedDungeonRoom::GetDoorLayout() const
+{
+	FDoorLayout Layout;
+	for (int32 WallIndex{ 0 }; WallIndex < FDoorLayout::NumWalls; ++WallIndex)
+	{
+		Layout.SetWallMask(FDoorLayout::WallDirections[WallIndex], DoorMasks[WallIndex]);
+	}
+	return Layout;
+}
+
+void FReplicatedDungeonRoom::SetDoorLayout(const FDoorLayout& Layout)
+{
+	for (int32 WallIndex{ 0 }; WallIndex < FDoorLayout::NumWalls; ++WallIndex)
+	{
+		DoorMasks[WallIndex] = Layout.GetWallMask(FDoorLayout::WallDirections[WallIndex]);
+	}
+}
+
+bool FReplicatedDungeonRoom::NetSerialize(FArchive& Archive, UPackageMap* PackageMap, bool& bOutSuccess)
+{
+	uint32 PackedAssetIndex{ static_cast<uint32>(AssetIndex) };
+	uint32 PackedLayoutIndex{ static_cast<uint32>(LayoutIndex) };
+	Archive.SerializeIntPacked(PackedAssetIndex);
+	Archive.SerializeIntPacked(PackedLayoutIndex);
+	AssetIndex  = static_cast<int32>(PackedAssetIndex);
+	LayoutIndex = static_cast<int32>(PackedLayoutIndex);
+
+	Archive << TileX;
+	Archive << TileY;
+
+	// rooms rarely have more than 32 segments per wall, so the high half of each mask is almost always a single zero byte
+	for (uint64& Mask : DoorMasks)
+	{
+		uint32 LowBits{ static_cast<uint32>(Mask) };
+		uint32 HighBits{ static_cast<uint32>(Mask >> 32) };
+		Archive.SerializeIntPacked(LowBits);
+		Archive.SerializeIntPacked(HighBits);
+		Mask = (static_cast<uint64>(HighBits) << 32) | LowBits;
+	}
+
+	bOutSuccess = !Archive.IsError();
+	return true;
+}
+
+void FReplicatedDungeonRoom::PostReplicatedAdd(const FReplicatedDungeonRoomArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnReplicatedRoomChanged(ReplicationID);
+	}
+}
+
+void FReplicatedDungeonRoom::PostReplicatedChange(const FReplicatedDungeonRoomArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnReplicatedRoomChanged(ReplicationID);
+	}
+}
+
+void FReplicatedDungeonRoom::PreReplicatedRemove(const FReplicatedDungeonRoomArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnReplicatedRoomRemoved(ReplicationID);
+	}
+}
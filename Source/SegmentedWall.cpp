@@ -1,5 +1,14 @@
 #include "SegmentedWall.h"
 
+#include "Dungeon/DungeonStats.h"
+
+#if WITH_EDITOR
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/SCS_Node.h"
+#include "Engine/SimpleConstructionScript.h"
+#include "UObject/ObjectSaveContext.h"
+#endif
+
 USegmentedWall::USegmentedWall()
 {
 	PrimaryComponentTick.bCanEverTick = false;
@@ -18,20 +27,85 @@ void USegmentedWall::InitializeComponent()
 
 void USegmentedWall::InitializeSegmentMeshes()
 {
-	auto WallSegments{ GetAttachChildren() };
-	m_SegmentMeshes.SetNum(WallSegments.Num()); // ensures every assignment is in bounds
+	DUNGEON_SCOPE_CYCLE_COUNTER(STAT_DungeonWallInitializeSegments);
+
+	const auto& WallSegments{ GetAttachChildren() };
+
+#if WITH_EDITOR
+	// the tags are only parsed again in the editor, where a blueprint edited since its last save must not spawn with a stale table
+	TArray<int32> SegmentIndexByChild;
+	const bool bIsTableBuilt{ BuildSegmentIndexTable(SegmentIndexByChild) };
+	checkf(bIsTableBuilt, TEXT("Error: SegmentedWall has invalid segments: %s"), *GetPathName());
 
-	for (auto WallSegment : WallSegments)
+	if (SegmentIndexByChild != m_SegmentIndexByChild)
 	{
-		UStaticMeshComponent* MeshComponent{ Cast<UStaticMeshComponent>(WallSegment) };
-		checkf(MeshComponent, TEXT("Error: SegmentedWall has a child that is not a static mesh: %s"), *GetPathName());
+		UE_LOG(LogTemp, Warning, TEXT("SegmentedWall has no up to date segment index table; resave its blueprint: %s"), *GetPathName());
+		m_SegmentIndexByChild = MoveTemp(SegmentIndexByChild);
+	}
+#else
+	if (m_SegmentIndexByChild.Num() != WallSegments.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SegmentedWall has no up to date segment index table; resave its blueprint to avoid parsing tags at runtime: %s"), *GetPathName());
 
-		int32 SegmentIndex{ GetIndexOfSegment(WallSegment) };
+		const bool bIsTableBuilt{ BuildSegmentIndexTable(m_SegmentIndexByChild) };
+		checkf(bIsTableBuilt, TEXT("Error: SegmentedWall has invalid segments: %s"), *GetPathName());
+	}
+#endif
 
-		m_SegmentMeshes[SegmentIndex] = MeshComponent;
+	m_SegmentMeshes.SetNum(WallSegments.Num());
+
+	for (int32 ChildIndex{ 0 }; ChildIndex < WallSegments.Num(); ++ChildIndex)
+	{
+		m_SegmentMeshes[m_SegmentIndexByChild[ChildIndex]] = CastChecked<UStaticMeshComponent>(WallSegments[ChildIndex]);
 	}
 }
 
+bool USegmentedWall::BuildSegmentIndexTable(TArray<int32>& OutSegmentIndexByChild) const
+{
+	const auto& WallSegments{ GetAttachChildren() };
+
+	TArray<const USceneComponent*> Segments;
+	Segments.Reserve(WallSegments.Num());
+	for (const USceneComponent* WallSegment : WallSegments)
+	{
+		Segments.Add(WallSegment);
+	}
+
+	return BuildSegmentIndexTable(Segments, OutSegmentIndexByChild);
+}
+
+bool USegmentedWall::BuildSegmentIndexTable(TConstArrayView<const USceneComponent*> Segments, TArray<int32>& OutSegmentIndexByChild) const
+{
+	OutSegmentIndexByChild.Reset(Segments.Num());
+	TBitArray<> IsIndexUsed{ false, Segments.Num() };
+
+	for (const USceneComponent* Segment : Segments)
+	{
+		if (!Cast<UStaticMeshComponent>(Segment))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Error: SegmentedWall has a child that is not a static mesh: %s"), *GetPathName());
+			return false;
+		}
+
+		int32 SegmentIndex{ INDEX_NONE };
+		if (!TryGetIndexOfSegment(Segment, SegmentIndex))
+		{
+			return false;
+		}
+
+		if (!IsIndexUsed.IsValidIndex(SegmentIndex) || IsIndexUsed[SegmentIndex])
+		{
+			UE_LOG(LogTemp, Error, TEXT("Error: A wall segment has an out of range or duplicate index tag: %s"), *GetPathName());
+			return false;
+		}
+
+		IsIndexUsed[SegmentIndex] = true;
+		OutSegmentIndexByChild.Add(SegmentIndex);
+	}
+
+	return true;
+}
+
 USegmentedWall::UWallSegment* USegmentedWall::GetSegment(int32 SegmentIndex)
 {
 	checkf(IsValidSegmentIndex(SegmentIndex), TEXT("Error: Attempted to get a wall segment that does not exist."));
@@ -40,15 +114,24 @@ USegmentedWall::UWallSegment* USegmentedWall::GetSegment(int32 SegmentIndex)
 }
 
 
-int32 USegmentedWall::GetIndexOfSegment(USceneComponent* Segment)
+bool USegmentedWall::TryGetIndexOfSegment(const USceneComponent* Segment, int32& OutSegmentIndex) const
 {
-	checkf(Segment->ComponentTags.Num() > 0, TEXT("Error: A wall segment is missing its index tag: %s"), *GetPathName());
+	if (Segment->ComponentTags.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: A wall segment is missing its index tag: %s"), *GetPathName());
+		return false;
+	}
 
 	FString TagValue{ Segment->ComponentTags[0].ToString() };
 
-	checkf(TagValue.IsNumeric(), TEXT("Error: A wall segment has an invalid index tag: %s"), *GetPathName());
+	if (!TagValue.IsNumeric())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: A wall segment has an invalid index tag: %s"), *GetPathName());
+		return false;
+	}
 	
-	return FCString::Atoi(*TagValue);
+	OutSegmentIndex = FCString::Atoi(*TagValue);
+	return true;
 }
 
 bool USegmentedWall::IsValidSegmentIndex(int32 SegmentIndex)
@@ -56,5 +139,76 @@ bool USegmentedWall::IsValidSegmentIndex(int32 SegmentIndex)
 	return m_SegmentMeshes.IsValidIndex(SegmentIndex);
 }
 
+int32 USegmentedWall::GetNumSegments() const
+{
+	return m_SegmentMeshes.Num();
+}
+
+#if WITH_EDITOR
+void USegmentedWall::PreSave(FObjectPreSaveContext SaveContext)
+{
+	Super::PreSave(SaveContext);
+
+	// a blueprint's walls have no attached children until spawned, so their segments are read from its construction scripts instead
+	TArray<const USceneComponent*> Segments;
+	if (!GetBlueprintSegmentTemplates(Segments))
+	{
+		for (const USceneComponent* WallSegment : GetAttachChildren())
+		{
+			Segments.Add(WallSegment);
+		}
+	}
+
+	TArray<int32> SegmentIndexByChild;
+	if (BuildSegmentIndexTable(Segments, SegmentIndexByChild))
+	{
+		m_SegmentIndexByChild = MoveTemp(SegmentIndexByChild);
+	}
+}
+
+bool USegmentedWall::GetBlueprintSegmentTemplates(TArray<const USceneComponent*>& OutSegments) const
+{
+	// native walls are subobjects of the class default object, while walls added in the blueprint are templates owned by the class itself
+	const UObject* Outer{ GetOuter() };
+	const UBlueprintGeneratedClass* Class{ Cast<UBlueprintGeneratedClass>(Outer) };
+	if (!Class && Outer && Outer->HasAnyFlags(RF_ClassDefaultObject))
+	{
+		Class = Cast<UBlueprintGeneratedClass>(Outer->GetClass());
+	}
+
+	if (!Class)
+	{
+		return false;
+	}
+
+	TArray<const UBlueprintGeneratedClass*> Classes;
+	UBlueprintGeneratedClass::GetGeneratedClassesHierarchy(Class, Classes);
 
+	// construction scripts run from the base class down and attach each node before its children, the same order as GetAllNodes
+	for (int32 ClassIndex{ Classes.Num() - 1 }; ClassIndex >= 0; --ClassIndex)
+	{
+		const USimpleConstructionScript* ConstructionScript{ Classes[ClassIndex]->SimpleConstructionScript };
+		if (!ConstructionScript)
+		{
+			continue;
+		}
+
+		for (const USCS_Node* Node : ConstructionScript->GetAllNodes())
+		{
+			if (Node->ComponentTemplate == this)
+			{
+				for (const USCS_Node* ChildNode : Node->GetChildNodes())
+				{
+					OutSegments.Add(Cast<USceneComponent>(ChildNode->ComponentTemplate));
+				}
+			}
+			else if (Node->ParentComponentOrVariableName == GetFName() && ConstructionScript->GetRootNodes().Contains(Node))
+			{
+				OutSegments.Add(Cast<USceneComponent>(Node->ComponentTemplate));
+			}
+		}
+	}
 
+	return true;
+}
+#endif
@@ -0,0 +1,385 @@
+/**
+ *
+ * Author: Matthew Papageorge
+ * Date: October 14, 2026
+ * Description: Automated benchmark suite for the dungeon's room systems.
+ * Benchmarks include:
+ * 	- Spawning rooms
+ * 	- Adding doors to rooms
+ * 	- Building the room database
+ * 	- Generating and spawning full dungeon layouts
+ *
+ * Room benchmarks run at scales of 10, 100, 1000 and 10000 rooms, for each of the benchmarked room sizes.
+ * Every benchmark reports the mean and 99th percentile time of a single operation, along with how much the process' used physical memory grew while it ran.
+ * Results are written as CSV and JSON to the Automation directory, named by the time of the run, so runs of different builds can be compared.
+ *
+ * @note Counting allocations is out of scope: the benchmark never hooks the allocator, so it only reports process memory growth.
+ *       That growth is read from the platform's memory stats and is coarse: it moves in whole pages, allocator caches absorb small allocations,
+ *       and every thread contributes. For allocation counts, run the benchmark with -trace=memalloc and inspect the trace in Unreal Insights.
+ * @note Test cases are executed within the Unreal development automation test framework.
+ *
+ */
+
+#include "Misc/AutomationTest.h"
+#include "Dungeon/Dungeon.h"
+#include "Dungeon/DungeonLayoutGenerator.h"
+#include "Dungeon/Rooms/DungeonRoom.h"
+#include "Dungeon/Rooms/DungeonRoomDatabase.h"
+#include "Dungeon/Rooms/DungeonRoomPool.h"
+
+#include "Engine/StreamableManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Tests/ApplicationTestUtilities.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+namespace
+{
+	const FString PathToAssets{ TEXT("/Game/Test/Dungeon/Rooms/DungeonRoom/") }; // the room assets to be used for conducting the benchmarks
+
+	const TCHAR* const DatabasePath{ TEXT("/Game/Test/Dungeon/Rooms/DungeonRoom") }; // the database built from the benchmarked assets
+
+	const EDungeonTheme BenchmarkTheme{ static_cast<EDungeonTheme>(0) }; // every benchmarked asset uses the first theme
+
+	const int32 Scales[]{ 10, 100, 1000, 10000 }; // the number of rooms each room benchmark is run with
+
+	const int32 NumDatabaseBuilds{ 10 }; // the number of times the database is built to measure its construction
+
+	/** The results of a single benchmark at a single scale. */
+	struct FBenchmarkResult
+	{
+		FString Name;			// the operation that was measured
+
+		FString RoomSize;		// the dimensions of the rooms used, or "Mixed" if every room size was used
+
+		int32   Scale;			// the number of rooms the benchmark was run with
+
+		int32   NumSamples;		// the number of times the operation was measured
+
+		double  MeanMilliseconds;	// the mean duration of the operation
+
+		double  P99Milliseconds;	// the 99th percentile duration of the operation
+
+		double  ProcessMemoryGrowthBytes;// the mean growth of the process' used physical memory over the operation; not an allocation count
+	};
+
+	/** A room asset used by the benchmarks, along with its dimensions. */
+	struct FBenchmarkAsset
+	{
+		FString CookedAssetName;	// the name of the asset within PathToAssets
+
+		FString RoomSize;		// the dimensions of the room, as reported in the results
+	};
+
+	const FBenchmarkAsset BenchmarkAssets[]
+	{
+		{ TEXT("CanAddDoorsToWallOfRoomAsset.CanAddDoorsToWallOfRoomAsset_C"), TEXT("2x2") },
+		{ TEXT("TestSpawnMethodSuiteAsset.TestSpawnMethodSuiteAsset_C"),       TEXT("4x4") },
+	};
+
+	/** Returns the memory currently used by the process, as reported by the platform; never replaces or hooks the allocator. */
+	int64 GetUsedPhysicalBytes()
+	{
+		return static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical);
+	}
+
+	/** Collects the duration of every sample of an operation, along with the memory growth over every sample. */
+	class FBenchmarkTimer
+	{
+	public:
+		/** Measures a single sample of the operation. */
+		template <typename FunctionType>
+		void Measure(FunctionType&& Operation)
+		{
+			const int64 StartBytes{ GetUsedPhysicalBytes() };
+			const double StartTime{ FPlatformTime::Seconds() };
+
+			Operation();
+
+			const double EndTime{ FPlatformTime::Seconds() };
+			m_MemoryGrowthBytes += GetUsedPhysicalBytes() - StartBytes;
+
+			// recorded once the sample has been measured, so that the timer's own allocations are left out
+			m_SampleMilliseconds.Add((EndTime - StartTime) * 1000.0);
+		}
+
+		/** Returns the results of every sample measured so far. */
+		FBenchmarkResult GetResult(const FString& Name, const FString& RoomSize, int32 Scale) const
+		{
+			FBenchmarkResult Result{ Name, RoomSize, Scale, m_SampleMilliseconds.Num(), 0.0, 0.0, 0.0 };
+			if (m_SampleMilliseconds.Num() == 0)
+			{
+				return Result;
+			}
+
+			TArray<double> SortedMilliseconds{ m_SampleMilliseconds };
+			SortedMilliseconds.Sort();
+
+			double TotalMilliseconds{ 0.0 };
+			for (const double Milliseconds : SortedMilliseconds)
+			{
+				TotalMilliseconds += Milliseconds;
+			}
+
+			// the nearest-rank percentile, so that a single sample is its own 99th percentile
+			const int32 P99Index{ FMath::CeilToInt32(0.99 * SortedMilliseconds.Num()) - 1 };
+
+			Result.MeanMilliseconds         = TotalMilliseconds / SortedMilliseconds.Num();
+			Result.P99Milliseconds          = SortedMilliseconds[P99Index];
+			Result.ProcessMemoryGrowthBytes = static_cast<double>(m_MemoryGrowthBytes) / SortedMilliseconds.Num();
+			return Result;
+		}
+
+	private:
+		TArray<double> m_SampleMilliseconds;		// The duration of every sample, in order
+
+		int64 m_MemoryGrowthBytes{ 0 };			// The memory growth summed over every sample; may be negative when memory is released
+	};
+
+	/** Returns the loaded room asset with the given name, or null if it failed to load. */
+	UObject* LoadBenchmarkAsset(FStreamableManager& StreamableManager, const FBenchmarkAsset& Asset)
+	{
+		return StreamableManager.LoadSynchronous(FSoftObjectPath{ PathToAssets + Asset.CookedAssetName });
+	}
+
+	/** Empties the world's pool, so that the next benchmark spawns every room from scratch. */
+	void EmptyRoomPool(UWorld* World)
+	{
+		if (UDungeonRoomPool* Pool{ World->GetSubsystem<UDungeonRoomPool>() })
+		{
+			Pool->Empty();
+		}
+	}
+
+	/** Destroys every room, then empties the world's pool. */
+	void DestroyRooms(TArray<ADungeonRoom*>& Rooms, UWorld* World)
+	{
+		for (ADungeonRoom* Room : Rooms)
+		{
+			if (IsValid(Room))
+			{
+				Room->Destroy();
+			}
+		}
+		Rooms.Reset();
+
+		EmptyRoomPool(World);
+	}
+
+	/**
+	 * Measures spawning rooms with ADungeonRoom::Spawn, then adding a door to each of them with ADungeonRoom::AddDoor.
+	 * Rooms are spawned apart from each other, as they would be in a dungeon, so that none of them overlap.
+	 */
+	void BenchmarkSpawningAndAddingDoors(FAutomationTestBase& This, UWorld* World, TArray<FBenchmarkResult>& OutResults)
+	{
+		FStreamableManager StreamableManager;
+
+		for (const FBenchmarkAsset& Asset : BenchmarkAssets)
+		{
+			UObject* LoadedAsset{ LoadBenchmarkAsset(StreamableManager, Asset) };
+			if (!LoadedAsset)
+			{
+				This.AddError(FString::Printf(TEXT("%s failed to load %s."), StringCast<TCHAR>(__FUNCTION__).Get(), *Asset.CookedAssetName));
+				continue;
+			}
+
+			for (const int32 Scale : Scales)
+			{
+				TArray<ADungeonRoom*> SpawnedRooms;
+				SpawnedRooms.Reserve(Scale);
+
+				{
+					FBenchmarkTimer Timer;
+					for (int32 RoomIndex{ 0 }; RoomIndex < Scale; ++RoomIndex)
+					{
+						ADungeonRoom::FSpawnInfo SpawnInfo;
+						SpawnInfo.LoadedAsset  = LoadedAsset;
+						SpawnInfo.RoomLocation = FVector{ RoomIndex * 10000.0f, 0.0f, 0.0f };
+						SpawnInfo.RandomStream = FRandomStream{ RoomIndex };
+
+						Timer.Measure([&SpawnInfo, &SpawnedRooms, World]() { SpawnedRooms.Add(ADungeonRoom::Spawn(SpawnInfo, World)); });
+					}
+					OutResults.Add(Timer.GetResult(TEXT("Spawn"), Asset.RoomSize, Scale));
+				}
+
+				{
+					const ADungeonRoom::FWallLocation DoorLocation{ EDirection::North, 0 };
+
+					FBenchmarkTimer Timer;
+					for (ADungeonRoom* Room : SpawnedRooms)
+					{
+						if (Room && !Room->HasDoorAtLocation(DoorLocation))
+						{
+							Timer.Measure([Room, &DoorLocation]() { Room->AddDoor(DoorLocation); });
+						}
+					}
+					OutResults.Add(Timer.GetResult(TEXT("AddDoor"), Asset.RoomSize, Scale));
+				}
+
+				DestroyRooms(SpawnedRooms, World);
+			}
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/** Measures building the room database from the benchmarked assets. */
+	void BenchmarkBuildingDatabase(TArray<FBenchmarkResult>& OutResults)
+	{
+		int32 NumAssets{ 0 };
+
+		FBenchmarkTimer Timer;
+		for (int32 BuildIndex{ 0 }; BuildIndex < NumDatabaseBuilds; ++BuildIndex)
+		{
+			Timer.Measure([&NumAssets]()
+			{
+				const FDungeonRoomDatabase Database{ DatabasePath };
+				NumAssets = Database.GetNumAssets();
+			});
+		}
+		OutResults.Add(Timer.GetResult(TEXT("BuildDatabase"), TEXT("Mixed"), NumAssets));
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/**
+	 * Measures generating a layout with FDungeonLayoutGenerator, then spawning it with ADungeon::SpawnLayout.
+	 * Each layout is released through ADungeon::ReleaseRooms before the next one is spawned, so later layouts reuse pooled rooms as floors do.
+	 */
+	void BenchmarkAssemblingDungeons(FAutomationTestBase& This, UWorld* World, TArray<FBenchmarkResult>& OutResults)
+	{
+		const TSharedRef<const FDungeonRoomDatabase> Database{ MakeShared<const FDungeonRoomDatabase>(DatabasePath) };
+
+		ADungeon* Dungeon{ World->SpawnActor<ADungeon>() };
+		if (!Dungeon)
+		{
+			This.AddError(FString::Printf(TEXT("%s failed to spawn a dungeon."), StringCast<TCHAR>(__FUNCTION__).Get()));
+			return;
+		}
+		Dungeon->SetRoomDatabase(Database);
+
+		EmptyRoomPool(World);
+
+		for (const int32 Scale : Scales)
+		{
+			const FDungeonLayoutGenerator Generator{ *Database, FDungeonLayoutGenerator::FSettings{ BenchmarkTheme, Scale } };
+
+			// small dungeons are assembled several times to give their percentiles meaning
+			const int32 NumIterations{ FMath::Max(1, 1000 / Scale) };
+
+			TArray<FDungeonLayout> Layouts;
+			Layouts.SetNum(NumIterations);
+
+			FBenchmarkTimer GenerateTimer;
+			int32 NumFailedLayouts{ 0 };
+			for (int32 Iteration{ 0 }; Iteration < NumIterations; ++Iteration)
+			{
+				bool bIsGenerated{ false };
+				GenerateTimer.Measure([&Generator, &Layouts, &bIsGenerated, Iteration]() { bIsGenerated = Generator.Generate(Iteration, Layouts[Iteration]); });
+				NumFailedLayouts += bIsGenerated ? 0 : 1;
+			}
+
+			// a partial layout would be timed as if it held every room, so the scale is skipped rather than reported
+			if (NumFailedLayouts > 0)
+			{
+				This.AddError(FString::Printf(TEXT("%s failed to generate %d of %d layouts of %d rooms; skipping the scale."),
+					StringCast<TCHAR>(__FUNCTION__).Get(), NumFailedLayouts, NumIterations, Scale));
+				continue;
+			}
+
+			const int32 NumRooms{ Layouts[0].Num() };
+			OutResults.Add(GenerateTimer.GetResult(TEXT("GenerateLayout"), TEXT("Mixed"), NumRooms));
+
+			{
+				FBenchmarkTimer Timer;
+				for (int32 Iteration{ 0 }; Iteration < NumIterations; ++Iteration)
+				{
+					Dungeon->ReleaseRooms();
+					Timer.Measure([Dungeon, &Layouts, Iteration]() { Dungeon->SpawnLayout(Layouts[Iteration], Iteration); });
+				}
+				OutResults.Add(Timer.GetResult(TEXT("SpawnLayout"), TEXT("Mixed"), NumRooms));
+			}
+
+			Dungeon->ReleaseRooms();
+		}
+
+		Dungeon->Destroy();
+		EmptyRoomPool(World);
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/** Writes the results as CSV and JSON files named after the time of the run; returns true if both were written. */
+	bool SaveResults(const TArray<FBenchmarkResult>& Results)
+	{
+		const FString Directory{ FPaths::Combine(FPaths::AutomationDir(), TEXT("DungeonRoomBenchmark")) };
+		const FString BaseFileName{ FString::Printf(TEXT("DungeonRoomBenchmark-%s"), *FDateTime::Now().ToString()) };
+
+		FString Csv{ TEXT("Build,Name,RoomSize,Scale,NumSamples,MeanMilliseconds,P99Milliseconds,ProcessMemoryGrowthBytes\n") };
+
+		FString Json{ FString::Printf(TEXT("{\n\t\"Build\": \"%s\",\n\t\"Results\": [\n"), FApp::GetBuildVersion()) };
+
+		for (int32 ResultIndex{ 0 }; ResultIndex < Results.Num(); ++ResultIndex)
+		{
+			const FBenchmarkResult& Result{ Results[ResultIndex] };
+
+			Csv += FString::Printf(TEXT("%s,%s,%s,%d,%d,%.6f,%.6f,%.2f\n"), FApp::GetBuildVersion(), *Result.Name, *Result.RoomSize,
+				Result.Scale, Result.NumSamples, Result.MeanMilliseconds, Result.P99Milliseconds, Result.ProcessMemoryGrowthBytes);
+
+			Json += FString::Printf(TEXT("\t\t{ \"Name\": \"%s\", \"RoomSize\": \"%s\", \"Scale\": %d, \"NumSamples\": %d, ")
+				TEXT("\"MeanMilliseconds\": %.6f, \"P99Milliseconds\": %.6f, \"ProcessMemoryGrowthBytes\": %.2f }%s\n"),
+				*Result.Name, *Result.RoomSize, Result.Scale, Result.NumSamples, Result.MeanMilliseconds, Result.P99Milliseconds,
+				Result.ProcessMemoryGrowthBytes, ResultIndex + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+		}
+
+		Json += TEXT("\t]\n}\n");
+
+		const bool bIsCsvSaved{ FFileHelper::SaveStringToFile(Csv, *FPaths::Combine(Directory, BaseFileName + TEXT(".csv"))) };
+		const bool bIsJsonSaved{ FFileHelper::SaveStringToFile(Json, *FPaths::Combine(Directory, BaseFileName + TEXT(".json"))) };
+
+		UE_LOG(LogTemp, Log, TEXT("Dungeon room benchmark results saved to %s"), *FPaths::Combine(Directory, BaseFileName));
+		return bIsCsvSaved && bIsJsonSaved;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonRoomBenchmark, "ARPG.Dungeon.Rooms.DungeonRoomBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FDungeonRoomBenchmark::RunTest(const FString& Parameters)
+{
+	UE_LOG(LogTemp, Log, TEXT("%s"), StringCast<TCHAR>(__FUNCTION__).Get());
+
+	UWorld* World{ ApplicationTestUtilities::GetUWorld() };
+	if (!World)
+	{
+		this->AddError(TEXT("Aborting Benchmark: Failed to get UWorld."));
+		return true;
+	}
+
+	TArray<FBenchmarkResult> Results;
+
+	BenchmarkSpawningAndAddingDoors(*this, World, Results);
+
+	BenchmarkBuildingDatabase(Results);
+
+	BenchmarkAssemblingDungeons(*this, World, Results);
+
+	for (const FBenchmarkResult& Result : Results)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s (%s, %d rooms): mean %.4f ms, p99 %.4f ms, %.1f bytes of process memory growth"), *Result.Name, *Result.RoomSize,
+			Result.Scale, Result.MeanMilliseconds, Result.P99Milliseconds, Result.ProcessMemoryGrowthBytes);
+	}
+
+	if (!SaveResults(Results))
+	{
+		this->AddError(TEXT("Failed to save the benchmark results."));
+	}
+
+	return true;
+}
+
+
+#endif
@@ -8,6 +8,16 @@
  *      - Detecting doors at specific locations
  * 	- Adding doors to the room
  * 	- Removing doors from the room
+ * 	- Applying door layouts to the room
+ * 	- Finalizing the room's segments
+ * 	- Keeping a segment's meshes when toggling its door
+ * 	- Toggling doors with dual segments
+ * 	- Reporting the room's memory
+ * 	- Generating layouts that are deterministic, free of overlaps and fully connected
+ * 	- Bounding generated layouts by an asset memory budget
+ * 	- Connecting, disconnecting and measuring distances in the room graph
+ * 	- Checking walls and door slots through fixed-size and runtime room layouts
+ * 	- Reusing pooled rooms
  * 
  * @note Test cases are executed within the Unreal development automation test framework.
  *
@@ -15,6 +25,10 @@
 
 #include "Misc/AutomationTest.h"
 #include "Dungeon/Rooms/DungeonRoom.h"
+#include "Dungeon/Rooms/DungeonRoomPool.h"
+#include "Dungeon/Rooms/RoomLayout.h"
+#include "Dungeon/DungeonLayoutGenerator.h"
+#include "Dungeon/DungeonRoomGraph.h"
 
 #include "Engine/StreamableManager.h"
 #include "Tests/ApplicationTestUtilities.h"
@@ -25,6 +39,8 @@ namespace
 	
 	const FString PathToAssets{ TEXT("/Game/Test/Dungeon/Rooms/DungeonRoom/") }; // the room assets to be used for conducting the tests
 
+	const TCHAR* const DatabasePath{ TEXT("/Game/Test/Dungeon/Rooms/DungeonRoom") }; // the database built from the test assets
+
 	/** 
 	 * Validates that rooms can accurately detect doors at specified locations.
 	 * 
@@ -188,6 +204,473 @@ namespace
 		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
 	}
 
+	/**
+	 * Validates that applying a door layout adds the doors missing from the room and removes the doors absent from the layout.
+	 *
+	 * @note This test relies on the proper functioning of ADungeonRoom::HasDoorAtLocation.
+	 */
+	void TestApplyingDoorLayout(FAutomationTestBase& This)
+	{
+		// The asset has 2 wall segments on the North, South, East, and West walls
+		const FString CookedAssetName{ TEXT("CanAddDoorsToWallOfRoomAsset.CanAddDoorsToWallOfRoomAsset_C") };
+		const FString RoomAssetPath{ PathToAssets + CookedAssetName };
+
+		using ApplicationTestUtilities::SpawnBlueprintAsset;
+		ADungeonRoom* SpawnedRoom{ Cast<ADungeonRoom>(SpawnBlueprintAsset(RoomAssetPath)) };
+		if (!SpawnedRoom)
+		{
+			const FString FunctionName{ StringCast<TCHAR>(__FUNCTION__).Get() };
+			const FString ErrorMessage{ FString::Printf(TEXT("%s failed to spawn room"), *FunctionName) };
+
+			This.AddError(ErrorMessage);
+			return;
+		}
+
+		FDoorLayout FirstLayout;
+		FirstLayout.AddDoor(EDirection::North, 0);
+		FirstLayout.AddDoor(EDirection::South, 1);
+
+		SpawnedRoom->ApplyDoorLayout(FirstLayout);
+
+		This.TestTrue(TEXT("Applying a layout must add its doors to the room."),
+			SpawnedRoom->HasDoorAtLocation({ EDirection::North, 0 }) &&
+			SpawnedRoom->HasDoorAtLocation({ EDirection::South, 1 }));
+
+		FDoorLayout SecondLayout;
+		SecondLayout.AddDoor(EDirection::South, 1);
+		SecondLayout.AddDoor(EDirection::East, 0);
+
+		SpawnedRoom->ApplyDoorLayout(SecondLayout);
+
+		This.TestTrue(TEXT("Applying a layout must keep the doors it shares with the room and add the missing ones."),
+			SpawnedRoom->HasDoorAtLocation({ EDirection::South, 1 }) &&
+			SpawnedRoom->HasDoorAtLocation({ EDirection::East, 0 }));
+
+		This.TestFalse(TEXT("Applying a layout must remove the doors absent from the layout."),
+			SpawnedRoom->HasDoorAtLocation({ EDirection::North, 0 }));
+
+		This.TestTrue(TEXT("The room's door layout must match the applied layout."),
+			SpawnedRoom->GetDoorLayout() == SecondLayout);
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/**
+	 * Validates that finalized rooms keep changing doors as normal, and that restoring them undoes the finalization.
+	 */
+	void TestFinalizingRoom(FAutomationTestBase& This)
+	{
+		// The asset has 2 wall segments on the North, South, East, and West walls
+		const FString CookedAssetName{ TEXT("CanAddDoorsToWallOfRoomAsset.CanAddDoorsToWallOfRoomAsset_C") };
+		const FString RoomAssetPath{ PathToAssets + CookedAssetName };
+
+		using ApplicationTestUtilities::SpawnBlueprintAsset;
+		ADungeonRoom* SpawnedRoom{ Cast<ADungeonRoom>(SpawnBlueprintAsset(RoomAssetPath)) };
+		if (!SpawnedRoom)
+		{
+			const FString FunctionName{ StringCast<TCHAR>(__FUNCTION__).Get() };
+			const FString ErrorMessage{ FString::Printf(TEXT("%s failed to spawn room"), *FunctionName) };
+
+			This.AddError(ErrorMessage);
+			return;
+		}
+
+		const ADungeonRoom::FWallLocation DoorLocation{ EDirection::West, 1 };
+
+		SpawnedRoom->FinalizeSegments();
+		This.TestTrue(TEXT("A room must be finalized once its segments are merged."), SpawnedRoom->IsFinalized());
+
+		SpawnedRoom->AddDoor(DoorLocation);
+		This.TestTrue(TEXT("Doors must be added to finalized rooms."), SpawnedRoom->HasDoorAtLocation(DoorLocation));
+		This.TestTrue(TEXT("Changing a door must not undo the finalization of the other segments."), SpawnedRoom->IsFinalized());
+
+		SpawnedRoom->RemoveDoor(DoorLocation);
+		This.TestFalse(TEXT("Doors must be removed from finalized rooms."), SpawnedRoom->HasDoorAtLocation(DoorLocation));
+
+		SpawnedRoom->RestoreSegments();
+		This.TestFalse(TEXT("A room must not be finalized once its segments are restored."), SpawnedRoom->IsFinalized());
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/**
+	 * Validates that toggling a door keeps the door and wall meshes the segment was first given.
+	 */
+	void TestTogglingDoorKeepsMeshes(FAutomationTestBase& This)
+	{
+		// The asset has 2 wall segments on the North, South, East, and West walls
+		const FString CookedAssetName{ TEXT("CanAddDoorsToWallOfRoomAsset.CanAddDoorsToWallOfRoomAsset_C") };
+		const FString RoomAssetPath{ PathToAssets + CookedAssetName };
+
+		using ApplicationTestUtilities::SpawnBlueprintAsset;
+		ADungeonRoom* SpawnedRoom{ Cast<ADungeonRoom>(SpawnBlueprintAsset(RoomAssetPath)) };
+		if (!SpawnedRoom)
+		{
+			const FString FunctionName{ StringCast<TCHAR>(__FUNCTION__).Get() };
+			const FString ErrorMessage{ FString::Printf(TEXT("%s failed to spawn room"), *FunctionName) };
+
+			This.AddError(ErrorMessage);
+			return;
+		}
+
+		const ADungeonRoom::FWallLocation DoorLocation{ EDirection::North, 0 };
+		const UStaticMesh* WallMesh{ SpawnedRoom->GetSegmentMesh(DoorLocation) };
+
+		SpawnedRoom->AddDoor(DoorLocation);
+		const UStaticMesh* DoorMesh{ SpawnedRoom->GetSegmentMesh(DoorLocation) };
+
+		SpawnedRoom->RemoveDoor(DoorLocation);
+		This.TestTrue(TEXT("Removing a door must restore the segment's previous wall mesh."), SpawnedRoom->GetSegmentMesh(DoorLocation) == WallMesh);
+
+		SpawnedRoom->AddDoor(DoorLocation);
+		This.TestTrue(TEXT("Adding a door again must reuse the segment's previous door mesh."), SpawnedRoom->GetSegmentMesh(DoorLocation) == DoorMesh);
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/**
+	 * Validates that a room pairing its segments with companions shows the same meshes as one updating its segments in place.
+	 */
+	void TestTogglingDoorWithDualSegments(FAutomationTestBase& This)
+	{
+		// The asset has 2 wall segments on the North, South, East, and West walls
+		const FString CookedAssetName{ TEXT("CanAddDoorsToWallOfRoomAsset.CanAddDoorsToWallOfRoomAsset_C") };
+		const FString RoomAssetPath{ PathToAssets + CookedAssetName };
+
+		using ApplicationTestUtilities::SpawnBlueprintAsset;
+		ADungeonRoom* SpawnedRoom{ Cast<ADungeonRoom>(SpawnBlueprintAsset(RoomAssetPath)) };
+		if (!SpawnedRoom)
+		{
+			const FString FunctionName{ StringCast<TCHAR>(__FUNCTION__).Get() };
+			const FString ErrorMessage{ FString::Printf(TEXT("%s failed to spawn room"), *FunctionName) };
+
+			This.AddError(ErrorMessage);
+			return;
+		}
+
+		SpawnedRoom->EnableDualSegments();
+
+		const ADungeonRoom::FWallLocation DoorLocation{ EDirection::North, 0 };
+		const UStaticMesh* WallMesh{ SpawnedRoom->GetSegmentMesh(DoorLocation) };
+
+		SpawnedRoom->AddDoor(DoorLocation);
+		const UStaticMesh* DoorMesh{ SpawnedRoom->GetSegmentMesh(DoorLocation) };
+		This.TestTrue(TEXT("Adding a door with dual segments must be detected."), SpawnedRoom->HasDoorAtLocation(DoorLocation));
+		This.TestTrue(TEXT("Adding a door with dual segments must show a door mesh."), DoorMesh && DoorMesh != WallMesh);
+
+		SpawnedRoom->RemoveDoor(DoorLocation);
+		This.TestFalse(TEXT("Removing a door with dual segments must be detected."), SpawnedRoom->HasDoorAtLocation(DoorLocation));
+		This.TestTrue(TEXT("Removing a door with dual segments must show the segment's previous wall mesh."), SpawnedRoom->GetSegmentMesh(DoorLocation) == WallMesh);
+
+		SpawnedRoom->AddDoor(DoorLocation);
+		This.TestTrue(TEXT("Adding a door again with dual segments must show the segment's previous door mesh."), SpawnedRoom->GetSegmentMesh(DoorLocation) == DoorMesh);
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/**
+	 * Validates that a room's memory report counts every segment and the meshes the room references.
+	 */
+	void TestMemoryReport(FAutomationTestBase& This)
+	{
+		// The asset has 2 wall segments on the North, South, East, and West walls
+		const FString CookedAssetName{ TEXT("CanAddDoorsToWallOfRoomAsset.CanAddDoorsToWallOfRoomAsset_C") };
+		const FString RoomAssetPath{ PathToAssets + CookedAssetName };
+
+		using ApplicationTestUtilities::SpawnBlueprintAsset;
+		ADungeonRoom* SpawnedRoom{ Cast<ADungeonRoom>(SpawnBlueprintAsset(RoomAssetPath)) };
+		if (!SpawnedRoom)
+		{
+			const FString FunctionName{ StringCast<TCHAR>(__FUNCTION__).Get() };
+			const FString ErrorMessage{ FString::Printf(TEXT("%s failed to spawn room"), *FunctionName) };
+
+			This.AddError(ErrorMessage);
+			return;
+		}
+
+		const ADungeonRoom::FMemoryReport Report{ SpawnedRoom->GetMemoryReport() };
+		This.TestTrue(TEXT("The memory report must count a component for every segment."), Report.NumComponents >= 8);
+		This.TestTrue(TEXT("The memory report must measure the room's components."), Report.ComponentBytes > 0);
+		This.TestTrue(TEXT("The memory report must measure the meshes the room references."), Report.ReferencedAssetBytes > 0);
+		This.TestTrue(TEXT("A room cannot have more render proxies than components."), Report.NumRenderProxies <= Report.NumComponents);
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/**
+	 * Validates that generating twice with the same seed gives the same layout, and that the layout has no overlapping rooms
+	 * and connects every room through facing doors.
+	 */
+	void TestLayoutGeneration(FAutomationTestBase& This)
+	{
+		const EDungeonTheme Theme{ static_cast<EDungeonTheme>(0) }; // every test asset uses the first theme
+		const int32 NumSeeds{ 16 };
+
+		const FDungeonRoomDatabase Database{ DatabasePath };
+		const FDungeonLayoutGenerator Generator{ Database, FDungeonLayoutGenerator::FSettings{ Theme, 8 } };
+
+		int32 NumGenerated{ 0 };
+		FDungeonLayout Layout;
+		FDungeonLayout RepeatedLayout;
+		for (int32 Seed{ 0 }; Seed < NumSeeds; ++Seed)
+		{
+			const bool bIsGenerated{ Generator.Generate(Seed, Layout) };
+			This.TestTrue(TEXT("Generating with the same seed must give the same result."), Generator.Generate(Seed, RepeatedLayout) == bIsGenerated);
+			if (!bIsGenerated)
+			{
+				continue;
+			}
+			++NumGenerated;
+
+			const TArray<FDungeonLayoutRoom>& Rooms{ Layout.GetRooms() };
+			const TArray<FDungeonLayoutRoom>& RepeatedRooms{ RepeatedLayout.GetRooms() };
+			if (!This.TestTrue(TEXT("Generating with the same seed must place the same number of rooms."), Rooms.Num() == RepeatedRooms.Num()))
+			{
+				continue;
+			}
+
+			for (int32 RoomIndex{ 0 }; RoomIndex < Rooms.Num(); ++RoomIndex)
+			{
+				const FDungeonLayoutRoom& Room{ Rooms[RoomIndex] };
+				const FDungeonLayoutRoom& RepeatedRoom{ RepeatedRooms[RoomIndex] };
+				const bool bIsSameRoom{ Room.AssetPath == RepeatedRoom.AssetPath && Room.Footprint.Origin == RepeatedRoom.Footprint.Origin
+					&& Room.Footprint.Width == RepeatedRoom.Footprint.Width && Room.Footprint.Length == RepeatedRoom.Footprint.Length && Room.Doors == RepeatedRoom.Doors };
+				This.TestTrue(TEXT("Generating with the same seed must place the same rooms with the same doors."), bIsSameRoom);
+
+				for (int32 OtherIndex{ RoomIndex + 1 }; OtherIndex < Rooms.Num(); ++OtherIndex)
+				{
+					This.TestFalse(TEXT("Rooms of a generated layout must not overlap."), Room.Footprint.Intersects(Rooms[OtherIndex].Footprint));
+				}
+			}
+
+			// every door must face a door of the room across it, and the doors must join every room
+			FDungeonRoomGraph Graph;
+			for (int32 RoomIndex{ 0 }; RoomIndex < Rooms.Num(); ++RoomIndex)
+			{
+				Graph.AddRoom(RoomIndex);
+			}
+
+			const FDungeonTileGrid& Grid{ Layout.GetGrid() };
+			for (int32 RoomIndex{ 0 }; RoomIndex < Rooms.Num(); ++RoomIndex)
+			{
+				const FDungeonLayoutRoom& Room{ Rooms[RoomIndex] };
+				for (const EDirection Wall : FDoorLayout::WallDirections)
+				{
+					for (int32 SegmentIndex{ 0 }; SegmentIndex < Room.Footprint.GetNumSegments(Wall); ++SegmentIndex)
+					{
+						if (!Room.Doors.HasDoor(Wall, SegmentIndex))
+						{
+							continue;
+						}
+
+						This.TestTrue(TEXT("Doors of a generated layout must be placed on door slots."), Room.DoorSlots.HasDoor(Wall, SegmentIndex));
+
+						const int32 NeighborIndex{ Grid.FindNeighbor(RoomIndex, Wall, SegmentIndex) };
+						if (!This.TestTrue(TEXT("Every door of a generated layout must lead to a room."), NeighborIndex != INDEX_NONE))
+						{
+							continue;
+						}
+
+						const EDirection FacingWall{ FDungeonTileGrid::GetOppositeWall(Wall) };
+						const int32 FacingSegmentIndex{ Grid.FindFacingSegment(RoomIndex, Wall, SegmentIndex) };
+						This.TestTrue(TEXT("Every door of a generated layout must face a door."), Rooms[NeighborIndex].Doors.HasDoor(FacingWall, FacingSegmentIndex));
+
+						if (RoomIndex < NeighborIndex)
+						{
+							Graph.Connect(FRoomDoor{ RoomIndex, Wall, SegmentIndex }, FRoomDoor{ NeighborIndex, FacingWall, FacingSegmentIndex });
+						}
+					}
+				}
+			}
+
+			This.TestTrue(TEXT("A generated layout must connect every room."), Graph.IsFullyConnected());
+		}
+
+		This.TestTrue(TEXT("The test assets must generate at least one layout."), NumGenerated > 0);
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/**
+	 * Validates that layouts generated under an asset memory budget reuse assets to stay within it, and are rejected when no asset fits.
+	 */
+	void TestLayoutAssetBudget(FAutomationTestBase& This)
+	{
+		const EDungeonTheme Theme{ static_cast<EDungeonTheme>(0) }; // every test asset uses the first theme
+		const int32 NumSeeds{ 16 };
+
+		FDungeonRoomDatabase Database{ DatabasePath };
+		Database.MeasureAssetSizes();
+
+		int64 LargestAssetSize{ 0 };
+		TArray<FDungeonRoomSpecs> ThemeSpecs;
+		Database.GetRoomSpecs(Theme, ThemeSpecs);
+		for (const FDungeonRoomSpecs& Specs : ThemeSpecs)
+		{
+			for (const FSoftObjectPath& AssetPath : Database.GetAssetPaths(Specs))
+			{
+				LargestAssetSize = FMath::Max(LargestAssetSize, Database.GetEstimatedAssetSize(AssetPath));
+			}
+		}
+
+		if (LargestAssetSize <= 0)
+		{
+			const FString FunctionName{ StringCast<TCHAR>(__FUNCTION__).Get() };
+			This.AddError(FString::Printf(TEXT("%s failed to measure the test assets."), *FunctionName));
+			return;
+		}
+
+		FDungeonLayoutGenerator::FSettings Settings{ Theme, 4 };
+
+		// any single asset fits, but a layout only stays within the budget by reusing the assets it already holds
+		Settings.AssetMemoryBudgetBytes = LargestAssetSize;
+		const FDungeonLayoutGenerator BudgetedGenerator{ Database, Settings };
+
+		// no asset fits, so even the first room is rejected
+		Settings.AssetMemoryBudgetBytes = 1;
+		const FDungeonLayoutGenerator RejectingGenerator{ Database, Settings };
+
+		FDungeonLayout Layout;
+		for (int32 Seed{ 0 }; Seed < NumSeeds; ++Seed)
+		{
+			if (BudgetedGenerator.Generate(Seed, Layout))
+			{
+				This.TestTrue(TEXT("A layout generated under a budget must reference assets within it."), BudgetedGenerator.GetEstimatedAssetSize(Layout) <= LargestAssetSize);
+			}
+
+			This.TestFalse(TEXT("A layout must be rejected when no asset fits within the budget."), RejectingGenerator.Generate(Seed, Layout));
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/**
+	 * Validates that the room graph tracks components and distances as rooms are connected, disconnected and connected again.
+	 *
+	 * @note The graph is a pure data structure, so no rooms are spawned.
+	 */
+	void TestRoomGraph(FAutomationTestBase& This)
+	{
+		// a chain 0 - 1 - 2 - 3 and a lone room 4
+		FDungeonRoomGraph Graph;
+		for (int32 RoomIndex{ 0 }; RoomIndex < 5; ++RoomIndex)
+		{
+			Graph.AddRoom(RoomIndex);
+		}
+
+		const FRoomDoor DoorA{ 0, EDirection::East, 0 };
+		const FRoomDoor DoorB{ 1, EDirection::West, 0 };
+		const FRoomDoor DoorC{ 1, EDirection::East, 0 };
+		const FRoomDoor DoorD{ 2, EDirection::West, 0 };
+		const FRoomDoor DoorE{ 2, EDirection::East, 0 };
+		const FRoomDoor DoorF{ 3, EDirection::West, 0 };
+
+		This.TestTrue(TEXT("A graph without edges must have a component per room."), Graph.GetNumComponents() == 5);
+
+		Graph.Connect(DoorA, DoorB);
+		Graph.Connect(DoorC, DoorD);
+		Graph.Connect(DoorE, DoorF);
+
+		This.TestTrue(TEXT("Connecting doors must add an edge per pair."), Graph.GetNumEdges() == 3);
+		This.TestTrue(TEXT("Both doors of an edge must be connected."), Graph.IsConnected(DoorA) && Graph.IsConnected(DoorB));
+		This.TestTrue(TEXT("Rooms joined through other rooms must be connected."), Graph.AreConnected(0, 3));
+		This.TestFalse(TEXT("A room without edges must not be connected to others."), Graph.AreConnected(0, 4));
+		This.TestTrue(TEXT("The chain and the lone room must form two components."), Graph.GetNumComponents() == 2);
+		This.TestFalse(TEXT("A chain must not have a loop."), Graph.HasLoop());
+
+		This.TestTrue(TEXT("The distance along the chain must count its edges."), Graph.GetDistance(0, 3) == 3);
+		This.TestTrue(TEXT("Unreachable rooms must have no distance."), Graph.GetDistance(0, 4) == INDEX_NONE);
+
+		TArray<int32> Distances;
+		const int32 SourceRooms[]{ 0, 3 };
+		Graph.GetDistances(SourceRooms, Distances);
+		This.TestTrue(TEXT("Distances must be measured from the nearest source."), Distances == TArray<int32>{ 0, 1, 1, 0, INDEX_NONE });
+
+		// removing the middle edge splits the chain in two
+		Graph.Disconnect(DoorD);
+
+		This.TestFalse(TEXT("Disconnecting a door must disconnect its facing door too."), Graph.IsConnected(DoorC) || Graph.IsConnected(DoorD));
+		This.TestTrue(TEXT("Disconnecting must remove the edge."), Graph.GetNumEdges() == 2);
+		This.TestFalse(TEXT("Removing the only path must split the component."), Graph.AreConnected(0, 3));
+		This.TestTrue(TEXT("Each side of the split must stay connected."), Graph.AreConnected(0, 1) && Graph.AreConnected(2, 3));
+		This.TestTrue(TEXT("Splitting the chain must add a component."), Graph.GetNumComponents() == 3);
+		This.TestTrue(TEXT("Split rooms must have no distance."), Graph.GetDistance(0, 3) == INDEX_NONE);
+
+		TArray<int32> Neighbors;
+		Graph.GetNeighbors(1, Neighbors);
+		This.TestTrue(TEXT("A disconnected room must no longer be a neighbor."), Neighbors == TArray<int32>{ 0 });
+
+		// connecting the lone room to both halves, while the sets are still stale, joins every room again through it
+		Graph.Disconnect(DoorA);
+		Graph.Connect(DoorA, FRoomDoor{ 4, EDirection::West, 0 });
+		Graph.Connect(FRoomDoor{ 4, EDirection::East, 0 }, DoorD);
+		Graph.Connect(DoorB, FRoomDoor{ 4, EDirection::North, 0 });
+
+		This.TestTrue(TEXT("Re-connecting must join every room."), Graph.IsFullyConnected());
+		This.TestTrue(TEXT("Re-connecting must add the new edges."), Graph.GetNumEdges() == 4);
+		This.TestFalse(TEXT("A graph with an edge fewer than rooms must not have a loop."), Graph.HasLoop());
+		This.TestTrue(TEXT("The distance must follow the new path."), Graph.GetDistance(0, 3) == 3 && Graph.GetDistance(1, 2) == 2);
+
+		// a second edge between the same rooms closes a loop
+		Graph.Connect(DoorC, FRoomDoor{ 4, EDirection::South, 0 });
+		This.TestTrue(TEXT("A second path between two rooms must form a loop."), Graph.HasLoop());
+
+		Graph.Reset();
+		This.TestTrue(TEXT("Resetting must remove every room and edge."), Graph.GetNumRooms() == 0 && Graph.GetNumEdges() == 0);
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
+	/**
+	 * Validates that fixed-size room layouts know their walls at compile time and agree with the runtime layout they fall back to.
+	 *
+	 * @note Room layouts are plain data, so no rooms are spawned.
+	 */
+	void TestRoomLayout(FAutomationTestBase& This)
+	{
+		using FLayout2x3 = TRoomLayout<2, 3>;
+		static_assert(FLayout2x3::GetNumSegments(EDirection::North) == 2 && FLayout2x3::GetNumSegments(EDirection::East) == 3, "Segment counts must be known at compile time");
+		static_assert(FLayout2x3::IsValidWallLocation(EDirection::West, 2) && !FLayout2x3::IsValidWallLocation(EDirection::South, 2), "Wall locations must be checked at compile time");
+
+		FDoorLayout OutsideWalls;
+		OutsideWalls.AddDoor(EDirection::North, 2);
+		This.TestFalse(TEXT("A door past the end of a wall must make the layout invalid."), FLayout2x3::IsValidLayout(OutsideWalls));
+
+		FDoorLayout DoorSlots;
+		DoorSlots.AddDoor(EDirection::North, 1);
+		DoorSlots.AddDoor(EDirection::East, 2);
+
+		FDoorLayout Doors;
+		Doors.AddDoor(EDirection::East, 2);
+
+		// every size the visitor handles, fixed or not, must answer like the runtime layout of the same size
+		const FIntPoint Sizes[]{ { 2, 3 }, { 4, 4 }, { 6, 3 } };
+		for (const FIntPoint& Size : Sizes)
+		{
+			const FRuntimeRoomLayout RuntimeLayout{ Size.X, Size.Y, Doors };
+			for (const EDirection Wall : FDoorLayout::WallDirections)
+			{
+				for (int32 SegmentIndex{ -1 }; SegmentIndex <= RuntimeLayout.GetNumSegments(Wall); ++SegmentIndex)
+				{
+					const bool bAreLayoutsEqual{ VisitRoomLayout(Size.X, Size.Y, Doors, [&RuntimeLayout, &DoorSlots, Wall, SegmentIndex](const auto& RoomLayout)
+					{
+						return RoomLayout.GetNumSegments(Wall) == RuntimeLayout.GetNumSegments(Wall)
+							&& RoomLayout.IsValidWallLocation(Wall, SegmentIndex) == RuntimeLayout.IsValidWallLocation(Wall, SegmentIndex)
+							&& RoomLayout.IsFreeDoorSlot(DoorSlots, Wall, SegmentIndex) == RuntimeLayout.IsFreeDoorSlot(DoorSlots, Wall, SegmentIndex);
+					}) };
+					This.TestTrue(FString::Printf(TEXT("A %dx%d room layout must match the runtime layout of its size."), Size.X, Size.Y), bAreLayoutsEqual);
+				}
+			}
+		}
+
+		const FRuntimeRoomLayout RuntimeLayout{ 2, 3, Doors };
+		This.TestTrue(TEXT("A door slot without a door must be free."), RuntimeLayout.IsFreeDoorSlot(DoorSlots, EDirection::North, 1));
+		This.TestFalse(TEXT("A door slot holding a door must not be free."), RuntimeLayout.IsFreeDoorSlot(DoorSlots, EDirection::East, 2));
+		This.TestFalse(TEXT("A segment that is not a door slot must not be free."), RuntimeLayout.IsFreeDoorSlot(DoorSlots, EDirection::North, 0));
+
+		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
+	}
+
 	/** 
 	 * Validates that rooms created via ADungeonRoom::Spawn have doors at the specified locations.
 	 * 
@@ -260,6 +743,49 @@ namespace
 			This.AddError(ErrorMessage);
 		}
 	}
+
+	/** 
+	 * Verifies that ADungeonRoom::Spawn reuses a room released to the world's pool, with the released room's doors removed.
+	 */
+	void TestIfSpawnMethodReusesPooledRoom(
+		FAutomationTestBase& This,
+		UObject* AssetToSpawn,
+		UWorld* WorldToSpawnIn
+	)
+	{
+		UDungeonRoomPool* Pool{ WorldToSpawnIn->GetSubsystem<UDungeonRoomPool>() };
+		if (!Pool)
+		{
+			This.AddError(TEXT("TestIfSpawnMethodReusesPooledRoom() failed to get the room pool."));
+			return;
+		}
+
+		const ADungeonRoom::FWallLocation ReleasedDoorLocation{ EDirection::North, 0 };
+		const ADungeonRoom::FWallLocation ReusedDoorLocation{ EDirection::South, 1 };
+
+		ADungeonRoom::FSpawnInfo SpawnInfo;
+		SpawnInfo.LoadedAsset = AssetToSpawn;
+		SpawnInfo.RoomLocation = FVector{ };
+		SpawnInfo.DoorLocations.Add(ReleasedDoorLocation);
+
+		ADungeonRoom* ReleasedRoom{ ADungeonRoom::Spawn(SpawnInfo, WorldToSpawnIn) };
+		if (!ReleasedRoom)
+		{
+			This.AddError(TEXT("TestIfSpawnMethodReusesPooledRoom() failed to spawn room."));
+			return;
+		}
+		Pool->Release(ReleasedRoom);
+
+		SpawnInfo.DoorLocations.Reset();
+		SpawnInfo.DoorLocations.Add(ReusedDoorLocation);
+
+		ADungeonRoom* ReusedRoom{ ADungeonRoom::Spawn(SpawnInfo, WorldToSpawnIn) };
+
+		This.TestTrue(TEXT("Spawning must reuse a pooled room of the same class."), ReusedRoom == ReleasedRoom);
+		This.TestFalse(TEXT("A reused room must not keep the doors it had when it was released."), ReusedRoom->HasDoorAtLocation(ReleasedDoorLocation));
+		This.TestTrue(TEXT("A reused room must have doors at the specified locations."), ReusedRoom->HasDoorAtLocation(ReusedDoorLocation));
+		This.TestFalse(TEXT("A reused room must be visible."), ReusedRoom->IsHidden());
+	}
 						     
 	/**
 	 * Executes a suite of tests for ADungeonRoom::Spawn, ensuring the spawned room
@@ -296,6 +822,8 @@ namespace
 
 		TestIfSpawnMethodSpawnsRoomAtExpectedLocation(This, LoadedAsset, WorldToSpawnIn);
 
+		TestIfSpawnMethodReusesPooledRoom(This, LoadedAsset, WorldToSpawnIn);
+
 		UE_LOG(LogTemp, Log, TEXT("%s completed"), StringCast<TCHAR>(__FUNCTION__).Get());
 	}
 }
@@ -306,6 +834,11 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonRoomTest, "ARPG.Dungeon.Rooms.DungeonRo
 bool FDungeonRoomTest::RunTest(const FString& Parameters)
 {
 	UE_LOG(LogTemp, Log, TEXT("%s"), StringCast<TCHAR>(__FUNCTION__).Get());
+
+	// the room graph and room layouts do not spawn rooms, so they do not depend on door detection
+	TestRoomGraph(*this);
+
+	TestRoomLayout(*this);
 	
 	if (TestDetectingDoor(*this) && TestNotIncorrectlyDetectingDoor(*this))
 	{
@@ -315,6 +848,20 @@ bool FDungeonRoomTest::RunTest(const FString& Parameters)
 
 		TestRemovingDoorsFromRoom(*this);
 
+		TestApplyingDoorLayout(*this);
+
+		TestFinalizingRoom(*this);
+
+		TestTogglingDoorKeepsMeshes(*this);
+
+		TestTogglingDoorWithDualSegments(*this);
+
+		TestMemoryReport(*this);
+
+		TestLayoutGeneration(*this);
+
+		TestLayoutAssetBudget(*this);
+
 		TestSpawnMethodSuite(*this);
 	}
 	else